@@ -7,6 +7,7 @@ pacman -S --needed \
   file \
   openssl \
   capstone \
+  zlib \
   nlohmann-json \
   glm \
   python3 \
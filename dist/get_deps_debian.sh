@@ -16,6 +16,7 @@ apt install \
   ${PKGCONF:-} \
   nlohmann-json3-dev \
   libcapstone-dev \
+  zlib1g-dev \
   libmagic-dev \
   libglfw3-dev \
   libglm-dev \
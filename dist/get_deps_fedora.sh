@@ -4,6 +4,7 @@ dnf install \
   cmake \
   gcc-c++ \
   capstone-devel \
+  zlib-devel \
   file-devel \
   glfw-devel \
   glm-devel \
@@ -5,6 +5,7 @@ pacman -S --needed \
   mingw-w64-x86_64-cmake \
   mingw-w64-x86_64-make \
   mingw-w64-x86_64-capstone \
+  mingw-w64-x86_64-zlib \
   mingw-w64-x86_64-glfw \
   mingw-w64-x86_64-glm \
   mingw-w64-x86_64-file \
@@ -46,8 +46,13 @@
 
 #include <stdio.h>      // sprintf, scanf
 #include <stdint.h>     // uint8_t, etc.
+#include <float.h>      // FLT_MAX
+#include <stddef.h>     // ptrdiff_t
+#include <algorithm>    // std::min
 #include "helpers/utils.hpp"
 
+#include "imgui_internal.h"
+
 #include "views/view.hpp"
 
 #ifdef _MSC_VER
@@ -88,10 +93,16 @@ struct MemoryEditor
     ImU32           HighlightColor;                             //          // background color of highlighted bytes.
     ImU8            (*ReadFn)(const ImU8* data, size_t off);    // = 0      // optional handler to read bytes.
     void            (*WriteFn)(ImU8* data, size_t off, ImU8 d); // = 0      // optional handler to write bytes.
+    void            (*BulkReadFn)(const ImU8* data, size_t off, ImU8* buf, size_t size); // = 0 // optional handler to read all visible bytes at once, takes precedence over ReadFn for them.
     bool            (*HighlightFn)(const ImU8* data, size_t off, bool next);//= 0      // optional handler to return Highlight property (to support non-contiguous highlighting).
 
+    // Only this many lines are laid out for scrolling at once so scroll positions stay exact as floats and the line count fits into the clipper.
+    // The window of lines starts at LineBase and gets moved along as the view comes close to its ends, so every line of big data stays reachable.
+    static constexpr size_t MaxScrollLines = 0x4'0000;
+
     // [Internal State]
     bool            ContentsWidthChanged;
+    size_t          LineBase;
     size_t          DataPreviewAddr;
     size_t          DataPreviewAddrOld;
     size_t          DataPreviewAddrEnd;
@@ -104,6 +115,8 @@ struct MemoryEditor
     size_t          HighlightMin, HighlightMax;
     int             PreviewEndianess;
     ImGuiDataType   PreviewDataType;
+    ImVector<ImU8>  VisibleData;
+    size_t          VisibleDataAddr;
 
     MemoryEditor()
     {
@@ -120,20 +133,30 @@ struct MemoryEditor
         HighlightColor = IM_COL32(255, 255, 255, 50);
         ReadFn = NULL;
         WriteFn = NULL;
+        BulkReadFn = NULL;
         HighlightFn = NULL;
 
         // State/Internals
         ContentsWidthChanged = false;
+        LineBase = 0;
         DataPreviewAddr = DataEditingAddr = DataPreviewAddrEnd = (size_t)-1;
         DataEditingTakeFocus = false;
         memset(DataInputBuf, 0, sizeof(DataInputBuf));
         memset(AddrInputBuf, 0, sizeof(AddrInputBuf));
         GotoAddr = (size_t)-1;
         HighlightMin = HighlightMax = (size_t)-1;
+        VisibleDataAddr = 0;
         PreviewEndianess = 0;
         PreviewDataType = ImGuiDataType_S32;
     }
 
+    ImU8 ReadByte(const ImU8* mem_data, size_t addr) const
+    {
+        if (addr >= VisibleDataAddr && addr - VisibleDataAddr < (size_t)VisibleData.Size)
+            return VisibleData[(int)(addr - VisibleDataAddr)];
+        return ReadFn ? ReadFn(mem_data, addr) : mem_data[addr];
+    }
+
     void GotoAddrAndHighlight(size_t addr_min, size_t addr_max)
     {
         GotoAddr = addr_min;
@@ -257,11 +280,23 @@ struct MemoryEditor
         ImGuiListClipper clipper;
         ImDrawList* draw_list = ImGui::GetWindowDrawList();
 
-        const int line_total_count = (int)((mem_size + Cols - 1) / Cols);
-        clipper.Begin(line_total_count, s.LineHeight);
+        // The clipper only sees the lines of the scroll window, its line indices are relative to LineBase
+        const size_t line_total_count = (mem_size + Cols - 1) / Cols;
+        const size_t line_window_count = std::min(line_total_count, MaxScrollLines);
+        LineBase = std::min(LineBase, line_total_count - line_window_count);
+        clipper.Begin((int)line_window_count, s.LineHeight);
         clipper.Step();
-        const size_t visible_start_addr = clipper.DisplayStart * Cols;
-        const size_t visible_end_addr = clipper.DisplayEnd * Cols;
+        const size_t visible_start_addr = (LineBase + clipper.DisplayStart) * Cols;
+        const size_t visible_end_addr = (LineBase + clipper.DisplayEnd) * Cols;
+
+        // Fetch all visible bytes in one go instead of going through ReadFn for every cell of both columns
+        VisibleData.resize(0);
+        VisibleDataAddr = visible_start_addr;
+        if (BulkReadFn && visible_start_addr < mem_size)
+        {
+            VisibleData.resize((int)(std::min(visible_end_addr, mem_size) - visible_start_addr));
+            BulkReadFn(mem_data, visible_start_addr, VisibleData.Data, (size_t)VisibleData.Size);
+        }
 
         bool data_next = false;
 
@@ -293,7 +328,7 @@ struct MemoryEditor
         if (data_preview_addr_next != (size_t)-1 && (data_preview_addr_next / Cols) != (data_preview_addr_backup / Cols))
         {
             // Track cursor movements
-            const int scroll_offset = ((int)(data_preview_addr_next / Cols) - (int)(data_preview_addr_backup / Cols));
+            const int scroll_offset = (int)((ptrdiff_t)(data_preview_addr_next / Cols) - (ptrdiff_t)(data_preview_addr_backup / Cols));
             const bool scroll_desired = (scroll_offset < 0 && data_preview_addr_next < visible_start_addr + Cols * 2) || (scroll_offset > 0 && data_preview_addr_next > visible_end_addr - Cols * 2);
             if (scroll_desired)
                 ImGui::SetScrollY(ImGui::GetScrollY() + scroll_offset * s.LineHeight);
@@ -301,7 +336,7 @@ struct MemoryEditor
         if (data_editing_addr_next != (size_t)-1 && (data_editing_addr_next / Cols) != (data_editing_addr_backup / Cols))
         {
             // Track cursor movements
-            const int scroll_offset = ((int)(data_editing_addr_next / Cols) - (int)(data_editing_addr_backup / Cols));
+            const int scroll_offset = (int)((ptrdiff_t)(data_editing_addr_next / Cols) - (ptrdiff_t)(data_editing_addr_backup / Cols));
             const bool scroll_desired = (scroll_offset < 0 && data_editing_addr_next < visible_start_addr + Cols * 2) || (scroll_offset > 0 && data_editing_addr_next > visible_end_addr - Cols * 2);
             if (scroll_desired)
                 ImGui::SetScrollY(ImGui::GetScrollY() + scroll_offset * s.LineHeight);
@@ -322,7 +357,7 @@ struct MemoryEditor
 
         for (int line_i = clipper.DisplayStart; line_i < clipper.DisplayEnd; line_i++) // display only visible lines
         {
-            size_t addr = (size_t)(line_i * Cols);
+            size_t addr = (LineBase + line_i) * Cols;
             ImGui::Text(format_address, s.AddrDigitsCount, base_display_addr + addr);
 
             // Draw Hexadecimal
@@ -366,7 +401,7 @@ struct MemoryEditor
                         ImGui::SetKeyboardFocusHere();
                         ImGui::CaptureKeyboardFromApp(true);
                         sprintf(AddrInputBuf, format_data, s.AddrDigitsCount, base_display_addr + addr);
-                        sprintf(DataInputBuf, format_byte, ReadFn ? ReadFn(mem_data, addr) : mem_data[addr]);
+                        sprintf(DataInputBuf, format_byte, ReadByte(mem_data, addr));
                     }
                     ImGui::PushItemWidth(s.GlyphWidth * 2);
                     struct UserData
@@ -393,7 +428,7 @@ struct MemoryEditor
                     };
                     UserData user_data;
                     user_data.CursorPos = -1;
-                    sprintf(user_data.CurrentBufOverwrite, format_byte, ReadFn ? ReadFn(mem_data, addr) : mem_data[addr]);
+                    sprintf(user_data.CurrentBufOverwrite, format_byte, ReadByte(mem_data, addr));
                     ImGuiInputTextFlags flags = ImGuiInputTextFlags_CharsHexadecimal | ImGuiInputTextFlags_EnterReturnsTrue | ImGuiInputTextFlags_AutoSelectAll | ImGuiInputTextFlags_NoHorizontalScroll | ImGuiInputTextFlags_AlwaysInsertMode | ImGuiInputTextFlags_CallbackAlways;
                     if (ImGui::InputText("##data", DataInputBuf, 32, flags, UserData::Callback, &user_data))
                         data_write = data_next = true;
@@ -412,13 +447,15 @@ struct MemoryEditor
                             WriteFn(mem_data, addr, (ImU8)data_input_value);
                         else
                             mem_data[addr] = (ImU8)data_input_value;
+                        if (addr >= VisibleDataAddr && addr - VisibleDataAddr < (size_t)VisibleData.Size)
+                            VisibleData[(int)(addr - VisibleDataAddr)] = (ImU8)data_input_value;
                     }
                     ImGui::PopID();
                 }
                 else
                 {
                     // NB: The trailing space is not visible but ensure there's no gap that the mouse cannot click on.
-                    ImU8 b = ReadFn ? ReadFn(mem_data, addr) : mem_data[addr];
+                    ImU8 b = ReadByte(mem_data, addr);
 
                     if (OptShowHexII)
                     {
@@ -459,7 +496,7 @@ struct MemoryEditor
                 // Draw ASCII values
                 ImGui::SameLine(s.PosAsciiStart);
                 ImVec2 pos = ImGui::GetCursorScreenPos();
-                addr = line_i * Cols;
+                addr = (LineBase + line_i) * Cols;
 
                 ImGui::PushID(-1);
                 ImGui::SameLine();
@@ -474,7 +511,7 @@ struct MemoryEditor
                         draw_list->AddRectFilled(pos, ImVec2(pos.x + s.GlyphWidth, pos.y + s.LineHeight), ImGui::GetColorU32(ImGuiCol_FrameBg));
                         draw_list->AddRectFilled(pos, ImVec2(pos.x + s.GlyphWidth, pos.y + s.LineHeight), ImGui::GetColorU32(ImGuiCol_TextSelectedBg));
                     }
-                    unsigned char c = ReadFn ? ReadFn(mem_data, addr) : mem_data[addr];
+                    unsigned char c = ReadByte(mem_data, addr);
                     char display_c = (c < 32 || c >= 128) ? '.' : c;
                     draw_list->AddText(pos, (display_c == c) ? color_text : color_disabled, &display_c, &display_c + 1);
 
@@ -520,6 +557,7 @@ struct MemoryEditor
         IM_ASSERT(clipper.Step() == false);
         clipper.End();
         ImGui::PopStyleVar(2);
+        UpdateLineBase(s, line_total_count, line_window_count);
         ImGui::EndChild();
 
         if (data_next && DataEditingAddr < mem_size)
@@ -542,6 +580,42 @@ struct MemoryEditor
         ImGui::SetCursorPosX(s.WindowWidth);
     }
 
+    // Moves the scroll window along once the view gets close to one of its ends, the scroll position moves back by the same amount so
+    // nothing visibly changes. Dragging the scrollbar maps its position onto the whole data instead. Has to be called after the lines got drawn.
+    void UpdateLineBase(const Sizes& s, size_t line_total_count, size_t line_window_count)
+    {
+        // Going to an address picks its own window
+        if (line_total_count == line_window_count || GotoAddr != (size_t)-1)
+            return;
+
+        ImGuiWindow* window = ImGui::GetCurrentWindow();
+        const size_t max_line_base = line_total_count - line_window_count;
+
+        if (ImGui::GetActiveID() == ImGui::GetWindowScrollbarID(window, ImGuiAxis_Y))
+        {
+            if (window->ScrollMax.y > 0.0f)
+                LineBase = (size_t)((double)(window->Scroll.y / window->ScrollMax.y) * (double)max_line_base);
+            return;
+        }
+
+        const size_t scroll_line = (size_t)(window->Scroll.y / s.LineHeight);
+        const size_t middle_line = line_window_count / 2;
+
+        ptrdiff_t shift = 0;
+        if (scroll_line < line_window_count / 4 && LineBase > 0)
+            shift = -(ptrdiff_t)std::min(LineBase, middle_line - scroll_line);
+        else if (scroll_line > line_window_count * 3 / 4 && LineBase < max_line_base)
+            shift = (ptrdiff_t)std::min(max_line_base - LineBase, scroll_line - middle_line);
+
+        if (shift == 0)
+            return;
+
+        LineBase += shift;
+        window->Scroll.y -= (float)shift * s.LineHeight;
+        if (window->ScrollTarget.y < FLT_MAX)
+            window->ScrollTarget.y -= (float)shift * s.LineHeight;
+    }
+
     void DrawOptionsLine(const Sizes& s, void* mem_data, size_t mem_size, size_t base_display_addr)
     {
         IM_UNUSED(mem_data);
@@ -583,8 +657,14 @@ struct MemoryEditor
         {
             if (GotoAddr < mem_size)
             {
+                // Center the scroll window on the line so there's room to scroll in both directions
+                const size_t goto_line = GotoAddr / Cols;
+                const size_t line_total_count = (mem_size + Cols - 1) / Cols;
+                const size_t line_window_count = std::min(line_total_count, MaxScrollLines);
+                LineBase = std::min(goto_line - std::min(goto_line, line_window_count / 2), line_total_count - line_window_count);
+
                 ImGui::BeginChild("##scrolling");
-                ImGui::SetScrollFromPosY(ImGui::GetCursorStartPos().y + (GotoAddr / Cols) * ImGui::GetTextLineHeight());
+                ImGui::SetScrollFromPosY(ImGui::GetCursorStartPos().y + (float)(goto_line - LineBase) * ImGui::GetTextLineHeight());
                 ImGui::EndChild();
                 DataEditingAddr = DataPreviewAddr = GotoAddr;
                 DataEditingTakeFocus = true;
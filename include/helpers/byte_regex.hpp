@@ -0,0 +1,125 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hex {
+
+    /*
+     * Regular expression over raw bytes, compiled to DFAs up front so matching takes a single table lookup per byte and the
+     * compiled expression can be shared between threads. Supports literals, ., [] classes, \xHH, \d \w \s and their negations,
+     * groups, | and the * + ? {n,m} quantifiers. Matching is leftmost-longest and matches are limited to MaxMatchLength bytes.
+     */
+    class ByteRegex {
+    public:
+        constexpr static size_t MaxMatchLength  = 0x1000;
+        constexpr static size_t MaxNfaStateCount = 0x10000;
+        constexpr static size_t MaxDfaStateCount = 0x4000;
+
+        static std::optional<ByteRegex> compile(std::string_view pattern, std::string &error);
+
+        /* Upper bound of the length of all matches, MaxMatchLength if the pattern contains unbounded repetitions */
+        [[nodiscard]] size_t getMaxMatchLength() const { return this->m_maxMatchLength; }
+
+        /* True if a run of zeros contains a match, so holes in sparse files don't have to be skipped */
+        [[nodiscard]] bool matchesZeros() const;
+
+        /* Length of the longest match starting at the beginning of data, zero if there is none */
+        [[nodiscard]] size_t matchLength(const u8 *data, size_t size) const {
+            size = std::min(size, this->m_maxMatchLength);
+
+            u32 state = MatchStartState * this->m_classCount;
+            size_t length = 0;
+            for (size_t i = 0; i < size; i++) {
+                u32 next = this->m_matchTransitions[state + this->m_byteClasses[data[i]]];
+                state = next & ~AcceptingFlag;
+
+                if (state == DeadState)
+                    break;
+                if (next & AcceptingFlag)
+                    length = i + 1;
+            }
+
+            return length;
+        }
+
+        /*
+         * Calls the callback with the offset and the length of every non-overlapping match until it returns false. The data
+         * is scanned once by the search DFA, which only tells where matches end. Each time it finds one, the start positions
+         * that could belong to it are tried with the match DFA to find the leftmost-longest match.
+         */
+        template<typename Callback>
+        void find(std::span<const u8> data, Callback &&callback) const {
+            const u8 *bytes = data.data();
+            const size_t size = data.size();
+
+            size_t position = 0;
+            size_t tested = 0;
+            u32 state = SearchStartState;
+            for (size_t i = 0; i < size; i++) {
+                // Patterns starting with a single byte let memchr skip over everything that can't start a match
+                if (state == SearchStartState && this->m_startByte.has_value()) {
+                    auto found = static_cast<const u8*>(std::memchr(bytes + i, this->m_startByte.value(), size - i));
+                    if (found == nullptr)
+                        return;
+
+                    i = found - bytes;
+                }
+
+                u32 next = this->m_searchTransitions[state + this->m_byteClasses[bytes[i]]];
+                state = next & ~AcceptingFlag;
+
+                if (!(next & AcceptingFlag))
+                    continue;
+
+                // Matches can't start further back than the maximum match length, starts tried before never match
+                size_t end = i + 1;
+                size_t start = std::max({ position, tested, end > this->m_maxMatchLength ? end - this->m_maxMatchLength : 0 });
+
+                for (; start < end; start++) {
+                    size_t length = this->matchLength(bytes + start, size - start);
+                    if (length == 0)
+                        continue;
+
+                    if (!callback(start, length))
+                        return;
+
+                    position = tested = start + length;
+                    i = position - 1;
+                    state = SearchStartState;
+                    break;
+                }
+
+                tested = std::max(tested, end);
+            }
+        }
+
+    private:
+        ByteRegex() = default;
+
+        constexpr static u32 DeadState        = 0;
+        constexpr static u32 MatchStartState  = 1;
+        constexpr static u32 SearchStartState = 0;
+
+        /* Transitions hold the offset of the next state's row in the table, with the top bit set if that state accepts */
+        constexpr static u32 AcceptingFlag = 0x8000'0000;
+
+        std::array<u8, 256> m_byteClasses = { };
+        size_t m_classCount = 1;
+
+        std::vector<u32> m_matchTransitions;
+        std::vector<u32> m_searchTransitions;
+        std::optional<u8> m_startByte;
+
+        size_t m_maxMatchLength = MaxMatchLength;
+    };
+
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <array>
+#include <vector>
+
+#include "helpers/chunked_job.hpp"
+
+namespace hex {
+
+    /*
+     * Counts the values of all bytes of a provider and the entropy of up to BlockCount evenly sized blocks in the background.
+     * Holes in sparse files don't get read, the bytes of a block that weren't read are counted as zeros.
+     */
+    class ByteStatisticsJob : public ChunkedJob<std::vector<u32>> {
+    public:
+        constexpr static u64 BlockCount = 2048;
+
+        explicit ByteStatisticsJob(prv::Provider *provider);
+
+        /* Adds up the chunks finished so far, true once the statistics are complete */
+        bool takeResults();
+
+        [[nodiscard]] u64 getBlockSize() const { return this->m_blockSize; }
+        [[nodiscard]] const std::array<u64, 256>& getValueCounts() const { return this->m_valueCounts; }
+        [[nodiscard]] const std::vector<float>& getBlockEntropy() const { return this->m_blockEntropy; }
+        [[nodiscard]] float getAverageEntropy() const;
+
+    private:
+        static u64 calculateBlockSize(u64 size);
+        static std::vector<Chunk> splitBlocks(prv::Provider *provider, u64 size, u64 blockSize);
+
+        /* Finishes all blocks in front of the given one */
+        void finishBlocks(u64 endBlock);
+
+        u64 m_size;
+        u64 m_blockSize;
+
+        std::array<u64, 256> m_valueCounts = { };
+        std::array<u64, 256> m_blockValueCounts = { };
+        u64 m_currentBlock = 0;
+        std::vector<float> m_blockEntropy;
+    };
+
+}
\ No newline at end of file
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "helpers/utils.hpp"
+#include "providers/provider.hpp"
+
+namespace hex {
+
+    /*
+     * Work on the data of a provider running in the background. The extents get split into chunks that are processed by all
+     * cores in parallel. Chunks are read on the thread calling process() so providers don't need to be thread safe, the job
+     * therefore has to be destroyed before its provider. Neighbouring chunks overlap by overlapSize bytes.
+     */
+    template<typename ChunkResult>
+    class ChunkedJob {
+    public:
+        constexpr static size_t ChunkSize = 0x10'0000;
+
+        /* Chunks only get queued once per frame, enough of them have to be waiting to keep the workers busy until the next one */
+        constexpr static size_t MinQueuedChunks = 16;
+
+        /* Chunks hold size bytes of data but only their first searchSize bytes belong to them, the rest is overlap */
+        struct Chunk {
+            u64 address;
+            size_t size;
+            size_t searchSize;
+        };
+
+        using ChunkProcessor = std::function<void(std::span<const u8> data, const Chunk &chunk, ChunkResult &result)>;
+
+        ChunkedJob(prv::Provider *provider, const std::vector<Region> &extents, size_t overlapSize, ChunkProcessor processor)
+            : ChunkedJob(provider, splitExtents(extents, overlapSize), std::move(processor)) {
+
+        }
+
+        /* Chunks laid out by the caller may have any size and overlap each other, the progress is based on their search sizes */
+        ChunkedJob(prv::Provider *provider, std::vector<Chunk> chunks, ChunkProcessor processor)
+            : m_provider(provider), m_processor(std::move(processor)), m_chunks(std::move(chunks)) {
+
+            for (const auto &chunk : this->m_chunks)
+                this->m_totalSize += chunk.searchSize;
+
+            this->m_chunkResults.resize(this->m_chunks.size());
+            this->m_chunkFinished.resize(this->m_chunks.size(), false);
+
+            this->m_accessHint.emplace(provider, prv::AccessHint::Sequential);
+
+            const size_t workerCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+            for (size_t i = 0; i < workerCount; i++)
+                this->m_workers.emplace_back([this] { this->work(); });
+        }
+
+        virtual ~ChunkedJob() {
+            this->cancel();
+
+            for (auto &worker : this->m_workers)
+                worker.join();
+
+            this->m_accessHint.reset();
+        }
+
+        ChunkedJob(const ChunkedJob&) = delete;
+        ChunkedJob& operator=(const ChunkedJob&) = delete;
+
+        /* Hands chunks to the workers until the time budget is used up or enough of them are waiting already */
+        void process(std::chrono::steady_clock::duration budget) {
+            const auto start = std::chrono::steady_clock::now();
+            const size_t maxQueuedChunks = std::max(this->m_workers.size() * 2, MinQueuedChunks);
+
+            while (this->m_nextReadChunk < this->m_chunks.size()) {
+                {
+                    std::scoped_lock lock(this->m_mutex);
+                    if (this->m_cancelled || this->m_queue.size() >= maxQueuedChunks)
+                        return;
+                }
+
+                const auto &chunk = this->m_chunks[this->m_nextReadChunk];
+                auto view = this->m_provider->getView(chunk.address, chunk.size);
+
+                {
+                    std::scoped_lock lock(this->m_mutex);
+                    this->m_queue.emplace_back(this->m_nextReadChunk, std::move(view));
+                }
+                this->m_queueChanged.notify_one();
+
+                this->m_nextReadChunk++;
+
+                if (std::chrono::steady_clock::now() - start >= budget)
+                    break;
+            }
+
+            if (this->m_nextReadChunk == this->m_chunks.size()) {
+                {
+                    std::scoped_lock lock(this->m_mutex);
+                    this->m_readingDone = true;
+                }
+                this->m_queueChanged.notify_all();
+
+                this->m_accessHint.reset();
+            }
+        }
+
+        void cancel() {
+            {
+                std::scoped_lock lock(this->m_mutex);
+                this->m_cancelled = true;
+                this->m_queue.clear();
+            }
+
+            this->m_queueChanged.notify_all();
+        }
+
+        [[nodiscard]] bool isDone() {
+            std::scoped_lock lock(this->m_mutex);
+            return this->m_cancelled || this->m_finishedChunkCount == this->m_chunks.size();
+        }
+
+        [[nodiscard]] float getProgress() {
+            std::scoped_lock lock(this->m_mutex);
+            return this->m_totalSize == 0 ? 1.0F : float(this->m_finishedSize) / this->m_totalSize;
+        }
+
+    protected:
+        /* Calls the callback with every chunk finished so far and its result in order of their address, true once all chunks were taken */
+        template<typename Callback>
+        bool takeChunks(Callback &&callback) {
+            while (true) {
+                size_t index;
+                ChunkResult result;
+
+                {
+                    std::scoped_lock lock(this->m_mutex);
+                    if (this->m_nextTakenChunk >= this->m_chunks.size())
+                        return true;
+                    if (!this->m_chunkFinished[this->m_nextTakenChunk])
+                        return false;
+
+                    index = this->m_nextTakenChunk++;
+                    result = std::move(this->m_chunkResults[index]);
+                    this->m_chunkResults[index] = { };
+                }
+
+                callback(this->m_chunks[index], result);
+            }
+        }
+
+        prv::Provider *m_provider;
+
+    private:
+        static std::vector<Chunk> splitExtents(const std::vector<Region> &extents, size_t overlapSize) {
+            std::vector<Chunk> chunks;
+
+            for (const auto &extent : extents) {
+                u64 extentEnd = extent.address + extent.size;
+
+                for (u64 offset = extent.address; offset < extentEnd; offset += ChunkSize) {
+                    size_t searchSize = std::min<u64>(ChunkSize, extentEnd - offset);
+                    size_t size = std::min<u64>(ChunkSize + overlapSize, extentEnd - offset);
+
+                    chunks.push_back({ offset, size, searchSize });
+                }
+            }
+
+            return chunks;
+        }
+
+        void work() {
+            while (true) {
+                std::unique_lock lock(this->m_mutex);
+                this->m_queueChanged.wait(lock, [this] { return !this->m_queue.empty() || this->m_readingDone || this->m_cancelled; });
+
+                if (this->m_cancelled || this->m_queue.empty())
+                    return;
+
+                auto [index, view] = std::move(this->m_queue.front());
+                this->m_queue.pop_front();
+                lock.unlock();
+
+                const auto &chunk = this->m_chunks[index];
+
+                ChunkResult result = { };
+                this->m_processor(view.getSpan(), chunk, result);
+
+                lock.lock();
+                this->m_chunkResults[index] = std::move(result);
+                this->m_chunkFinished[index] = true;
+                this->m_finishedChunkCount++;
+                this->m_finishedSize += chunk.searchSize;
+            }
+        }
+
+        ChunkProcessor m_processor;
+
+        /* Only held while chunks are being read */
+        std::optional<prv::ScopedAccessHint> m_accessHint;
+
+        std::vector<Chunk> m_chunks;
+        std::vector<ChunkResult> m_chunkResults;
+        std::vector<bool> m_chunkFinished;
+        size_t m_nextReadChunk = 0;
+        size_t m_nextTakenChunk = 0;
+        size_t m_finishedChunkCount = 0;
+        u64 m_totalSize = 0;
+        u64 m_finishedSize = 0;
+
+        std::mutex m_mutex;
+        std::condition_variable m_queueChanged;
+        std::deque<std::pair<size_t, prv::DataView>> m_queue;
+        bool m_readingDone = false;
+        bool m_cancelled = false;
+
+        std::vector<std::thread> m_workers;
+    };
+
+}
\ No newline at end of file
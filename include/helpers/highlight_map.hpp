@@ -0,0 +1,39 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <optional>
+#include <vector>
+
+namespace hex {
+
+    /*
+     * Colors of highlighted address ranges. Ranges get collected in order of priority and are then flattened once into
+     * sorted, non-overlapping intervals where ranges added earlier cover the ones added later.
+     */
+    class HighlightMap {
+    public:
+        struct Interval {
+            u64 start;
+            u64 end;
+            u32 color;
+        };
+
+        void add(u64 address, size_t size, u32 color);
+        void build();
+        void clear();
+
+        [[nodiscard]] std::optional<u32> find(u64 address) const;
+
+        /* Lookups for increasing addresses, like the ones done while drawing rows, start at the previously found interval */
+        [[nodiscard]] std::optional<u32> find(u64 address, size_t &cursor) const;
+
+        [[nodiscard]] const std::vector<Interval>& getIntervals() const { return this->m_intervals; }
+        [[nodiscard]] bool empty() const { return this->m_intervals.empty() && this->m_pending.empty(); }
+
+    private:
+        std::vector<Interval> m_pending;
+        std::vector<Interval> m_intervals;
+    };
+
+}
\ No newline at end of file
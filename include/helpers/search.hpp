@@ -0,0 +1,213 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <array>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "helpers/utils.hpp"
+#include "helpers/byte_regex.hpp"
+#include "helpers/chunked_job.hpp"
+#include "helpers/search_results.hpp"
+#include "providers/provider.hpp"
+
+namespace hex {
+
+    /*
+     * Finds every occurrence of a byte sequence, including overlapping ones. Short sequences get located by scanning for
+     * their first byte with memchr which is vectorized by the C library, longer ones use Boyer-Moore-Horspool.
+     */
+    class SequenceMatcher {
+    public:
+        constexpr static size_t MinSkipTableLength = 4;
+
+        explicit SequenceMatcher(std::vector<u8> sequence);
+
+        [[nodiscard]] size_t getLength() const { return this->m_sequence.size(); }
+        [[nodiscard]] const std::vector<u8>& getSequence() const { return this->m_sequence; }
+
+        /* Calls the callback with the offset of every match inside of data until it returns false */
+        template<typename Callback>
+        void find(std::span<const u8> data, Callback &&callback) const {
+            const size_t length = this->m_sequence.size();
+            if (length == 0 || data.size() < length)
+                return;
+
+            const u8 *sequence = this->m_sequence.data();
+            const u8 *begin = data.data();
+            const u8 *last = begin + data.size() - length;
+
+            if (length < MinSkipTableLength) {
+                for (const u8 *curr = begin; curr <= last; curr++) {
+                    curr = static_cast<const u8*>(std::memchr(curr, sequence[0], (last - curr) + 1));
+                    if (curr == nullptr)
+                        return;
+
+                    if (std::memcmp(curr + 1, sequence + 1, length - 1) == 0 && !callback(size_t(curr - begin)))
+                        return;
+                }
+            } else {
+                const u8 lastByte = sequence[length - 1];
+                for (const u8 *curr = begin; curr <= last; curr += this->m_skipTable[curr[length - 1]]) {
+                    if (curr[length - 1] == lastByte && std::memcmp(curr, sequence, length - 1) == 0 && !callback(size_t(curr - begin)))
+                        return;
+                }
+            }
+        }
+
+    private:
+        std::vector<u8> m_sequence;
+        std::array<size_t, 256> m_skipTable = { };
+    };
+
+    /*
+     * Finds every occurrence of a byte sequence where only the bits set in the mask have to match. Candidates are located
+     * with memchr on the first fully masked byte, the comparison then checks eight bytes at a time.
+     */
+    class MaskedSequenceMatcher {
+    public:
+        MaskedSequenceMatcher(std::vector<u8> sequence, std::vector<u8> mask);
+
+        [[nodiscard]] size_t getLength() const { return this->m_sequence.size(); }
+
+        /* True if zeros match the sequence, so holes in sparse files don't have to be skipped */
+        [[nodiscard]] bool matchesZeros() const;
+
+        [[nodiscard]] bool matchesAt(const u8 *data) const {
+            const size_t length = this->m_sequence.size();
+
+            size_t i = 0;
+            for (; i + sizeof(u64) <= length; i += sizeof(u64)) {
+                u64 value, sequence, mask;
+                std::memcpy(&value, data + i, sizeof(u64));
+                std::memcpy(&sequence, this->m_sequence.data() + i, sizeof(u64));
+                std::memcpy(&mask, this->m_mask.data() + i, sizeof(u64));
+
+                if (((value ^ sequence) & mask) != 0)
+                    return false;
+            }
+
+            for (; i < length; i++) {
+                if (((data[i] ^ this->m_sequence[i]) & this->m_mask[i]) != 0)
+                    return false;
+            }
+
+            return true;
+        }
+
+        /* Calls the callback with the offset of every match inside of data until it returns false */
+        template<typename Callback>
+        void find(std::span<const u8> data, Callback &&callback) const {
+            const size_t length = this->m_sequence.size();
+            if (length == 0 || data.size() < length)
+                return;
+
+            const u8 *begin = data.data();
+            const u8 *last = begin + data.size() - length;
+
+            if (this->m_anchor.has_value()) {
+                const size_t anchor = this->m_anchor.value();
+                const u8 anchorByte = this->m_sequence[anchor];
+
+                for (const u8 *curr = begin; curr <= last; curr++) {
+                    auto found = static_cast<const u8*>(std::memchr(curr + anchor, anchorByte, (last - curr) + 1));
+                    if (found == nullptr)
+                        return;
+
+                    curr = found - anchor;
+                    if (this->matchesAt(curr) && !callback(size_t(curr - begin)))
+                        return;
+                }
+            } else {
+                for (const u8 *curr = begin; curr <= last; curr++) {
+                    if (this->matchesAt(curr) && !callback(size_t(curr - begin)))
+                        return;
+                }
+            }
+        }
+
+    private:
+        std::vector<u8> m_sequence;
+        std::vector<u8> m_mask;
+        std::optional<size_t> m_anchor;
+    };
+
+    /*
+     * Finds every occurrence of any number of byte sequences in a single pass using an Aho-Corasick automaton. Bytes that
+     * don't occur in any of the sequences share one column of the transition table to keep it small.
+     */
+    class MultiSequenceMatcher {
+    public:
+        explicit MultiSequenceMatcher(const std::vector<std::vector<u8>> &sequences);
+
+        [[nodiscard]] size_t getSequenceCount() const { return this->m_lengths.size(); }
+        [[nodiscard]] size_t getLength(u32 sequence) const { return this->m_lengths[sequence]; }
+        [[nodiscard]] size_t getMaxLength() const { return this->m_maxLength; }
+        [[nodiscard]] bool matchesZeros() const { return this->m_matchesZeros; }
+
+        /* Calls the callback with the offset and the index of the sequence of every match until it returns false */
+        template<typename Callback>
+        void find(std::span<const u8> data, Callback &&callback) const {
+            const size_t classCount = this->m_classCount;
+
+            u32 state = 0;
+            for (size_t i = 0; i < data.size(); i++) {
+                state = this->m_transitions[state * classCount + this->m_byteClasses[data[i]]];
+
+                for (u32 output = this->m_outputOffsets[state]; output < this->m_outputOffsets[state + 1]; output++) {
+                    u32 sequence = this->m_outputs[output];
+                    if (!callback(i + 1 - this->m_lengths[sequence], sequence))
+                        return;
+                }
+            }
+        }
+
+    private:
+        std::array<u8, 256> m_byteClasses = { };
+        size_t m_classCount = 1;
+
+        std::vector<u32> m_transitions;
+        std::vector<u32> m_outputOffsets;
+        std::vector<u32> m_outputs;
+
+        std::vector<size_t> m_lengths;
+        size_t m_maxLength = 0;
+        bool m_matchesZeros = false;
+    };
+
+    /* Searches one chunk of data starting at address and adds all matches starting within its first searchSize bytes to results */
+    using ChunkMatcher = std::function<void(std::span<const u8> data, size_t searchSize, u64 address, SearchResultList &results)>;
+
+    /*
+     * Search running in the background. Neighbouring chunks overlap by maxMatchLength - 1 bytes, matches starting inside of
+     * the overlap are only reported by the chunk they start in. Without overlapping matches, chunks are stitched together
+     * when their results get taken by matching again from the end of a match that reaches into the next chunk.
+     */
+    class SearchJob : public ChunkedJob<SearchResultList> {
+    public:
+        SearchJob(prv::Provider *provider, const std::vector<Region> &extents, size_t maxMatchLength, ChunkMatcher matcher, bool overlappingMatches = true);
+
+        /* Appends the matches of all chunks finished so far, in order of their address */
+        void takeResults(SearchResultList &results);
+
+    private:
+        void stitchResults(const Chunk &chunk, const SearchResultList &chunkResults, SearchResultList &results);
+
+        ChunkMatcher m_matcher;
+        size_t m_maxMatchLength;
+        bool m_overlappingMatches;
+        u64 m_matchesEnd = 0;
+    };
+
+    std::unique_ptr<SearchJob> searchSequence(prv::Provider *provider, const std::vector<u8> &sequence);
+    std::unique_ptr<SearchJob> searchMaskedSequence(prv::Provider *provider, const std::vector<u8> &sequence, const std::vector<u8> &mask);
+    std::unique_ptr<SearchJob> searchMultipleSequences(prv::Provider *provider, const std::vector<std::vector<u8>> &sequences);
+    std::unique_ptr<SearchJob> searchRegex(prv::Provider *provider, const ByteRegex &regex);
+
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace hex {
+
+    /* Start and end address of a match, the end being exclusive, and the index of the pattern that matched */
+    struct SearchResult {
+        u64 start;
+        u64 end;
+        u32 pattern;
+    };
+
+    /*
+     * Compact list of search results ordered by their start address. Results are stored in blocks, each one delta encoded
+     * relative to the previous result, so dense hits take up about one byte each. Once the limit is reached the list either
+     * stops storing results or keeps an evenly spaced sample of all of them while still counting every result.
+     */
+    class SearchResultList {
+    public:
+        enum class LimitMode {
+            Truncate,
+            Sample
+        };
+
+        constexpr static size_t BlockSize = 1024;
+
+        void add(const SearchResult &result);
+        void append(const SearchResultList &other);
+        void clear();
+
+        void setLimit(size_t limit, LimitMode mode);
+
+        [[nodiscard]] SearchResult get(size_t index) const;
+
+        /* Calls the callback with the index and the result of count results starting at first */
+        template<typename Callback>
+        void forEach(size_t first, size_t count, Callback &&callback) const {
+            count = std::min(count, this->m_count - std::min(first, this->m_count));
+
+            size_t index = first - (first % BlockSize);
+            for (size_t blockIndex = first / BlockSize; count > 0 && blockIndex < this->m_blocks.size(); blockIndex++) {
+                const auto &block = this->m_blocks[blockIndex];
+
+                SearchResult result = { block.start, block.start, 0 };
+                size_t position = 0;
+                for (u32 i = 0; i < block.count && count > 0; i++, index++) {
+                    decode(block, position, result);
+
+                    if (index >= first) {
+                        callback(index, result);
+                        count--;
+                    }
+                }
+            }
+        }
+
+        [[nodiscard]] size_t size() const { return this->m_count; }
+        [[nodiscard]] bool empty() const { return this->m_count == 0; }
+
+        /* Number of results that were added, including those that didn't get stored because of the limit */
+        [[nodiscard]] u64 getTotalCount() const { return this->m_totalCount; }
+        [[nodiscard]] bool isLimited() const { return this->m_totalCount != this->m_count; }
+
+    private:
+        struct Block {
+            u64 start;
+            u32 count;
+            std::vector<u8> data;
+        };
+
+        void store(const SearchResult &result);
+        static void decode(const Block &block, size_t &position, SearchResult &result);
+
+        std::vector<Block> m_blocks;
+        size_t m_count = 0;
+        u64 m_totalCount = 0;
+
+        SearchResult m_last = { };
+
+        size_t m_limit = 0;
+        LimitMode m_limitMode = LimitMode::Truncate;
+        u64 m_sampleStride = 1;
+    };
+
+}
\ No newline at end of file
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <span>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "helpers/chunked_job.hpp"
+
+namespace hex {
+
+    enum class StringEncoding : u8 {
+        ASCII,
+        UTF8,
+        UTF16LE,
+        UTF16BE
+    };
+
+    [[nodiscard]] const char* getStringEncodingName(StringEncoding encoding);
+
+    /* Strings only store where they were found, their text gets decoded from the data when it's needed */
+    struct FoundString {
+        u64 offset;
+        u32 size;
+        StringEncoding encoding;
+    };
+
+    /* String that may continue beyond the data it was found in, along with the number of characters it has so far */
+    struct PartialString {
+        FoundString string;
+        u64 length;
+    };
+
+    /*
+     * Strings consist of printable ASCII characters. UTF-8 strings may contain any valid multi-byte sequence that doesn't
+     * encode a control character, UTF-16 strings are made of characters up to U+00FF, which covers the wide strings of most
+     * binaries. The minimum length is counted in characters.
+     */
+    struct StringExtractionSettings {
+        size_t minimumLength = 5;
+        bool ascii = true;
+        bool utf8 = false;
+        bool utf16le = false;
+        bool utf16be = false;
+    };
+
+    /* Longest number of bytes a character of any of the encodings takes up */
+    constexpr static size_t MaxCharacterSize = 4;
+
+    /* Longer strings get split up so their size fits into FoundString */
+    constexpr static size_t MaxStringSize = 0xFFFF'FFF0;
+
+    /* Strings found in a piece of data. The ones at its edges are kept no matter how short they are as they may continue beyond it */
+    struct ExtractedStrings {
+        std::vector<FoundString> strings;
+        std::vector<PartialString> edgeStrings;
+    };
+
+    /*
+     * Extracts the strings with characters starting within the first searchSize bytes of data, the bytes after that are only
+     * used to complete the characters at the end. Strings starting within the first MaxCharacterSize bytes or ending at or
+     * after searchSize are edge strings.
+     */
+    void extractStrings(std::span<const u8> data, size_t searchSize, u64 address, const StringExtractionSettings &settings, ExtractedStrings &result);
+
+    /* Applies the minimum length to a complete string, UTF-8 strings without any multi-byte characters count as ASCII ones */
+    [[nodiscard]] bool finishString(PartialString &string, const StringExtractionSettings &settings);
+
+    /* Decodes the text of a string to UTF-8 */
+    [[nodiscard]] std::string decodeString(std::span<const u8> data, StringEncoding encoding);
+    [[nodiscard]] std::string readString(prv::Provider *provider, const FoundString &string);
+
+    /* Keeps the text of the most recently drawn strings around, the same rows get drawn every frame */
+    class StringTextCache {
+    public:
+        constexpr static size_t Capacity = 512;
+
+        /* The returned text stays valid until Capacity other strings were looked up */
+        const std::string& get(prv::Provider *provider, const FoundString &string);
+        void clear();
+
+    private:
+        using Key = std::tuple<u64, u32, StringEncoding>;
+
+        std::list<std::pair<Key, std::string>> m_entries;
+        std::map<Key, decltype(m_entries)::iterator> m_lookup;
+    };
+
+    /*
+     * Extracts all strings of a provider in the background. Strings crossing chunk boundaries get joined together when the
+     * results are taken, so they're found no matter how long they are.
+     */
+    class StringExtractionJob : public ChunkedJob<ExtractedStrings> {
+    public:
+        StringExtractionJob(prv::Provider *provider, const StringExtractionSettings &settings);
+
+        /* Appends the strings of all chunks finished so far, in order of their offset */
+        void takeResults(std::vector<FoundString> &results);
+
+    private:
+        StringExtractionSettings m_settings;
+
+        /* Edge strings that may still continue in the next chunk and finished strings that come after them */
+        std::vector<PartialString> m_pendingStrings;
+        std::vector<FoundString> m_heldStrings;
+    };
+
+    /*
+     * Finds the strings whose text contains the filter in the background. Strings get grouped into chunks by their offset
+     * so the data of each one is read only once, no matter in which order they are listed.
+     */
+    class StringFilterJob : public ChunkedJob<std::vector<u64>> {
+    public:
+        /* Filters the strings of a list, firstIndex is the index of the first of them within the list */
+        StringFilterJob(prv::Provider *provider, std::span<const FoundString> strings, u64 firstIndex, std::string filter);
+
+        /* Adds the list indices of the strings matching so far, keeping the indices in ascending order */
+        void takeResults(std::vector<u64> &indices);
+
+    private:
+        struct IndexedString {
+            FoundString string;
+            u64 index;
+        };
+
+        using IndexedStrings = std::shared_ptr<const std::vector<IndexedString>>;
+
+        StringFilterJob(prv::Provider *provider, IndexedStrings strings, std::string filter);
+
+        static IndexedStrings sortStrings(std::span<const FoundString> strings, u64 firstIndex);
+        static std::vector<Chunk> groupStrings(const std::vector<IndexedString> &strings);
+    };
+
+}
\ No newline at end of file
@@ -7,6 +7,7 @@
 
 #include "providers/provider.hpp"
 #include "helpers/utils.hpp"
+#include "helpers/highlight_map.hpp"
 #include "lang/token.hpp"
 
 #include <cstring>
@@ -77,13 +78,8 @@ namespace hex::lang {
                 return { };
         }
 
-        virtual std::map<u64, u32> getHighlightedAddresses() {
-            if (this->m_highlightedAddresses.empty()) {
-                for (u64 i = 0; i < this->getSize(); i++)
-                    this->m_highlightedAddresses.insert({ this->getOffset() + i, this->getColor() });
-            }
-
-            return this->m_highlightedAddresses;
+        virtual void addHighlightedRegions(HighlightMap &highlights) {
+            highlights.add(this->getOffset(), this->getSize(), this->getColor());
         }
 
         virtual void sort(ImGuiTableSortSpecs *sortSpecs, prv::Provider *provider) { }
@@ -167,7 +163,6 @@ namespace hex::lang {
 
     protected:
         std::endian m_endian = std::endian::native;
-        std::map<u64, u32> m_highlightedAddresses;
 
     private:
         u64 m_offset;
@@ -243,16 +238,9 @@ namespace hex::lang {
                 return { };
         }
 
-        std::map<u64, u32> getHighlightedAddresses() override {
-            if (this->m_highlightedAddresses.empty()) {
-                auto ownAddresses = PatternData::getHighlightedAddresses();
-                auto pointedToAddresses = this->m_pointedAt->getHighlightedAddresses();
-
-                ownAddresses.merge(pointedToAddresses);
-                this->m_highlightedAddresses = ownAddresses;
-            }
-
-            return this->m_highlightedAddresses;
+        void addHighlightedRegions(HighlightMap &highlights) override {
+            PatternData::addHighlightedRegions(highlights);
+            this->m_pointedAt->addHighlightedRegions(highlights);
         }
         [[nodiscard]] std::string getFormattedName() const override {
             return "Pointer";
@@ -459,14 +447,9 @@ namespace hex::lang {
             return { };
         }
 
-        std::map<u64, u32> getHighlightedAddresses() override {
-            if (this->m_highlightedAddresses.empty()) {
-                for (auto &entry : this->m_entries) {
-                    this->m_highlightedAddresses.merge(entry->getHighlightedAddresses());
-                }
-            }
-
-            return this->m_highlightedAddresses;
+        void addHighlightedRegions(HighlightMap &highlights) override {
+            for (auto &entry : this->m_entries)
+                entry->addHighlightedRegions(highlights);
         }
         [[nodiscard]] std::string getFormattedName() const override {
             return this->m_entries[0]->getTypeName() + "[" + std::to_string(this->m_entries.size()) + "]";
@@ -522,14 +505,9 @@ namespace hex::lang {
             return { };
         }
 
-        std::map<u64, u32> getHighlightedAddresses() override {
-            if (this->m_highlightedAddresses.empty()) {
-                for (auto &member : this->m_members) {
-                    this->m_highlightedAddresses.merge(member->getHighlightedAddresses());
-                }
-            }
-
-            return this->m_highlightedAddresses;
+        void addHighlightedRegions(HighlightMap &highlights) override {
+            for (auto &member : this->m_members)
+                member->addHighlightedRegions(highlights);
         }
 
         void sort(ImGuiTableSortSpecs *sortSpecs, prv::Provider *provider) override {
@@ -603,14 +581,9 @@ namespace hex::lang {
             return { };
         }
 
-        std::map<u64, u32> getHighlightedAddresses() override {
-            if (this->m_highlightedAddresses.empty()) {
-                for (auto &member : this->m_members) {
-                    this->m_highlightedAddresses.merge(member->getHighlightedAddresses());
-                }
-            }
-
-            return this->m_highlightedAddresses;
+        void addHighlightedRegions(HighlightMap &highlights) override {
+            for (auto &member : this->m_members)
+                member->addHighlightedRegions(highlights);
         }
 
         void sort(ImGuiTableSortSpecs *sortSpecs, prv::Provider *provider) override {
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "providers/provider.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <zlib.h>
+
+namespace hex::prv {
+
+    /*
+     * Read-only provider for gzip and zlib compressed files. Opening a file builds an index of checkpoints that store the
+     * state of the decompressor every few MiB and saves it beside the file, so random reads only have to decompress the data
+     * starting at the closest checkpoint instead of the entire file. Building the index decompresses the entire file, so it
+     * happens on a separate thread and the provider stays unavailable until it's done.
+     */
+    class CompressedFileProvider : public Provider {
+    public:
+        constexpr static size_t CheckpointSpan  = 0x10'0000;
+        constexpr static size_t WindowSize      = 0x8000;
+        constexpr static size_t InputBufferSize = 0x4000;
+
+        constexpr static auto IndexFileExtension = ".imhexidx";
+
+        explicit CompressedFileProvider(std::string_view path);
+        ~CompressedFileProvider() override;
+
+        bool isAvailable() override;
+        bool isReadable() override;
+        bool isWritable() override;
+
+        void readRaw(u64 offset, void *buffer, size_t size) override;
+        void writeRaw(u64 offset, const void *buffer, size_t size) override;
+        u64 getActualSize() override;
+
+        std::vector<std::pair<std::string, std::string>> getDataInformation() override;
+
+        [[nodiscard]] bool isIndexing() const { return this->m_indexing; }
+        [[nodiscard]] float getIndexingProgress() const;
+
+    private:
+        struct Checkpoint {
+            u64 uncompressedOffset;
+            u64 compressedOffset;
+            u8 bits;
+            std::vector<u8> window;
+        };
+
+        bool buildIndex();
+        bool loadIndex();
+        void storeIndex();
+
+        bool restartStream(const Checkpoint &checkpoint);
+        bool seekStream(u64 offset);
+        size_t inflateStream(u8 *buffer, size_t size);
+        bool skipInput(size_t size);
+
+        std::string m_path;
+        FILE *m_file = nullptr;
+        bool m_isGzip = false;
+
+        u64 m_compressedSize = 0;
+        u64 m_modificationTime = 0;
+        u64 m_uncompressedSize = 0;
+
+        /* The index and the uncompressed size may only be used once the index is loaded */
+        std::vector<Checkpoint> m_checkpoints;
+        std::atomic<bool> m_indexLoaded = false;
+
+        std::thread m_indexThread;
+        std::atomic<bool> m_indexing = false;
+        std::atomic<bool> m_cancelIndexing = false;
+        std::atomic<u64> m_indexedSize = 0;
+
+        /* The decompressor is kept alive between reads so sequential accesses don't have to start over at a checkpoint */
+        z_stream m_stream = { };
+        bool m_streamValid = false;
+        bool m_streamRaw = true;
+        u64 m_streamOffset = 0;
+        std::vector<u8> m_inputBuffer;
+    };
+
+}
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "providers/provider.hpp"
 
+#include <memory>
+#include <mutex>
 #include <string_view>
 
 #include <sys/stat.h>
@@ -14,6 +16,12 @@
 #include <sys/fcntl.h>
 #endif
 
+#if defined(OS_LINUX)
+#include <sys/ioctl.h>
+#include <sys/inotify.h>
+#include <linux/fs.h>
+#endif
+
 namespace hex::prv {
 
     class FileProvider : public Provider {
@@ -27,23 +35,75 @@ namespace hex::prv {
 
         void read(u64 offset, void *buffer, size_t size) override;
         void write(u64 offset, const void *buffer, size_t size) override;
+        DataView getView(u64 offset, size_t size) override;
+        bool saveAs(const std::string &path) override;
 
         void readRaw(u64 offset, void *buffer, size_t size) override;
         void writeRaw(u64 offset, const void *buffer, size_t size) override;
-        size_t getActualSize() override;
+        u64 getActualSize() override;
+        std::vector<Region> getDataExtentsRaw(u64 offset, size_t size) override;
+
+        void prefetch(u64 offset, size_t size) override;
+
+        std::vector<Region> checkForChanges() override;
 
         std::vector<std::pair<std::string, std::string>> getDataInformation() override;
 
+    protected:
+        void applyAccessHint(AccessHint hint) override;
+
     private:
+        /* Only a window of the file is mapped at a time so files bigger than the address space can be opened as well */
+        #if defined(ARCH_32_BIT)
+        constexpr static size_t MappingWindowSize = 0x0400'0000;
+        #else
+        constexpr static size_t MappingWindowSize = 0x1000'0000;
+        #endif
+        constexpr static size_t MappingWindowAlignment = 0x10'0000;
+
+        /* Streaming scans use a smaller window so the resident set stays bounded while walking over huge files */
+        constexpr static size_t SequentialWindowSize = 0x0400'0000;
+
+        struct MappedWindow {
+            u64 offset;
+            size_t size;
+            void *data;
+
+            ~MappedWindow();
+        };
+
+        std::shared_ptr<MappedWindow> getMappedWindow(u64 offset, size_t size);
+        void adviseWindow(const MappedWindow &window);
+
+        /*
+         * Changes done by other processes are found by comparing checksums of fixed size blocks of the file. Checksumming
+         * happens in small steps every time changes are checked for so huge files don't stall the interface
+         */
+        constexpr static size_t ChangeBlockSize         = 0x1'0000;
+        constexpr static size_t ChangeScanStepSize      = 0x100'0000;
+        constexpr static u64 MaxChecksummedFileSize     = 0x1'0000'0000;
+        constexpr static size_t MaxReportedChanges      = 16;
+
+        u64 getBlockChecksum(u64 blockIndex);
+
         #if defined(OS_WINDOWS)
-        HANDLE m_file;
-        HANDLE m_mapping;
+        HANDLE m_file = nullptr;
+        HANDLE m_mapping = nullptr;
         #else
-        int m_file;
+        int m_file = -1;
         #endif
         std::string m_path;
-        void *m_mappedFile;
-        size_t m_fileSize;
+        u64 m_fileSize = 0;
+
+        std::mutex m_windowMutex;
+        std::shared_ptr<MappedWindow> m_mappedWindow;
+
+        #if defined(OS_LINUX)
+        int m_fileWatch = -1;
+        #endif
+        std::vector<u64> m_blockChecksums;
+        u64 m_checksumPosition = 0;
+        bool m_checksumsValid = false;
 
         bool m_fileStatsValid = false;
         struct stat m_fileStats = { 0 };
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "providers/provider.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace hex::prv {
+
+    /*
+     * Provider backed by a growable buffer in memory, used for decoded imports, clipboard contents and data generated
+     * by scripts. Edits are kept as patches just like with files and only get written into the buffer when saving.
+     */
+    class MemoryProvider : public Provider {
+    public:
+        explicit MemoryProvider(std::vector<u8> &&data = { }, std::string name = "Memory");
+        ~MemoryProvider() override = default;
+
+        bool isAvailable() override;
+        bool isReadable() override;
+        bool isWritable() override;
+
+        void read(u64 offset, void *buffer, size_t size) override;
+        void write(u64 offset, const void *buffer, size_t size) override;
+        DataView getView(u64 offset, size_t size) override;
+
+        void readRaw(u64 offset, void *buffer, size_t size) override;
+        void writeRaw(u64 offset, const void *buffer, size_t size) override;
+        u64 getActualSize() override;
+
+        std::vector<std::pair<std::string, std::string>> getDataInformation() override;
+
+        [[nodiscard]] const std::string& getName() const { return this->m_name; }
+
+        /* Grows the buffer with zeros or truncates it. Writes past the end grow it automatically */
+        void resize(u64 size);
+
+    private:
+        std::string m_name;
+
+        /* Views keep the buffer alive. Writes copy it while views exist and growing reallocates it once it runs out of capacity */
+        std::shared_ptr<std::vector<u8>> m_data;
+    };
+
+}
\ No newline at end of file
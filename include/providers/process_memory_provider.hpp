@@ -0,0 +1,68 @@
+#pragma once
+
+#if defined(OS_LINUX)
+
+#include "providers/provider.hpp"
+
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace hex::prv {
+
+    /*
+     * Read-only view into the memory of a running process. The mapped segments are parsed from /proc/<pid>/maps and
+     * one of them is exposed at a time, with reads going through process_vm_readv and a page granular cache.
+     */
+    class ProcessMemoryProvider : public Provider {
+    public:
+        struct Segment {
+            u64 address;
+            size_t size;
+            std::string permissions;
+            std::string path;
+        };
+
+        constexpr static size_t PageSize        = 0x1000;
+        constexpr static size_t CachedPageCount = 256;
+
+        explicit ProcessMemoryProvider(pid_t pid);
+        ~ProcessMemoryProvider() override;
+
+        bool isAvailable() override;
+        bool isReadable() override;
+        bool isWritable() override;
+
+        void read(u64 offset, void *buffer, size_t size) override;
+
+        void readRaw(u64 offset, void *buffer, size_t size) override;
+        void writeRaw(u64 offset, const void *buffer, size_t size) override;
+        u64 getActualSize() override;
+        u64 getBaseAddress() override;
+
+        std::vector<std::pair<std::string, std::string>> getDataInformation() override;
+
+        [[nodiscard]] pid_t getPid() const { return this->m_pid; }
+        [[nodiscard]] const std::vector<Segment>& getSegments() const { return this->m_segments; }
+        [[nodiscard]] size_t getSelectedSegment() const { return this->m_selectedSegment; }
+        void selectSegment(size_t index);
+
+        /* The target keeps running, this drops all cached pages and re-reads the segment list */
+        void refresh();
+
+    private:
+        ssize_t readProcessMemory(u64 address, void *buffer, size_t size);
+        void parseSegments();
+
+        pid_t m_pid;
+        std::string m_processName;
+        int m_memoryFile = -1;
+
+        std::vector<Segment> m_segments;
+        size_t m_selectedSegment = 0;
+    };
+
+}
+
+#endif
\ No newline at end of file
@@ -1,11 +1,15 @@
 #pragma once
 
 #include "helpers/utils.hpp"
+#include "helpers/highlight_map.hpp"
+#include "helpers/search.hpp"
 #include "views/view.hpp"
 
 #include "imgui_memory_editor.h"
 #include "ImGuiFileBrowser.h"
 
+#include <chrono>
+#include <memory>
 #include <tuple>
 #include <random>
 #include <vector>
@@ -16,7 +20,8 @@ namespace hex {
 
     namespace prv { class Provider; }
 
-    using SearchFunction = std::vector<std::pair<u64, u64>> (*)(prv::Provider* &provider, std::string string);
+    /* Returns nullptr and sets the error if the search string is invalid */
+    using SearchFunction = std::unique_ptr<SearchJob> (*)(prv::Provider* &provider, std::string string, std::string &error);
 
     class ViewHexEditor : public View {
     public:
@@ -32,16 +37,33 @@ namespace hex {
         imgui_addons::ImGuiFileBrowser m_fileBrowser;
 
         std::vector<lang::PatternData*> &m_patternData;
-        std::map<u64, u32> m_highlightedBytes;
+        HighlightMap m_highlights;
+        size_t m_highlightCursor = 0;
 
         char m_searchStringBuffer[0xFFFF] = { 0 };
         char m_searchHexBuffer[0xFFFF] = { 0 };
         SearchFunction m_searchFunction = nullptr;
-        std::vector<std::pair<u64, u64>> *m_lastSearchBuffer;
+        std::string m_searchError;
+        SearchResultList *m_lastSearchBuffer;
 
         s64 m_lastSearchIndex = 0;
-        std::vector<std::pair<u64, u64>> m_lastStringSearch;
-        std::vector<std::pair<u64, u64>> m_lastHexSearch;
+        SearchResultList m_lastStringSearch;
+        SearchResultList m_lastHexSearch;
+
+        std::string m_searchListBuffer;
+        std::vector<std::string> m_searchListPatterns;
+        SearchResultList m_lastListSearch;
+
+        char m_searchRegexBuffer[0xFFFF] = { 0 };
+        SearchResultList m_lastRegexSearch;
+
+        /* Runs while frames are drawn and has to be reset before the provider it searches gets deleted */
+        constexpr static auto SearchTimeBudget = std::chrono::milliseconds(5);
+        constexpr static size_t MaxStoredSearchResults = 0x100'0000;
+        std::unique_ptr<SearchJob> m_searchJob;
+        SearchResultList *m_searchResults = nullptr;
+        bool m_sampleSearchResults = false;
+        bool m_searchJumpPending = false;
 
         s64 m_gotoAddress = 0;
 
@@ -50,10 +72,22 @@ namespace hex {
         std::string m_loaderScriptScriptPath;
         std::string m_loaderScriptFilePath;
 
+        int m_processId = 0;
+
+        bool m_waitingForIndex = false;
+
+        void processSearch();
         void drawSearchPopup();
         void drawGotoPopup();
 
         void openFile(std::string path);
+        void openCompressedFile(std::string path);
+        void drawIndexingPopup();
+        void openMemory(std::vector<u8> &&data, std::string name);
+        #if defined(OS_LINUX)
+        void openProcess(int pid);
+        void drawProcessPopup();
+        #endif
         bool saveToFile(std::string path, const std::vector<u8>& data);
         bool loadFromFile(std::string path, std::vector<u8>& data);
 
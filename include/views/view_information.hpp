@@ -1,9 +1,12 @@
 #pragma once
 
 #include "views/view.hpp"
+#include "helpers/byte_statistics.hpp"
 
 #include <array>
+#include <chrono>
 #include <cstdio>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -21,7 +24,7 @@ namespace hex {
 
     private:
         bool m_dataValid = false;
-        u32 m_blockSize = 0;
+        u64 m_blockSize = 0;
         float m_averageEntropy = 0;
         float m_highestBlockEntropy = 0;
         std::vector<float> m_blockEntropy;
@@ -29,10 +32,17 @@ namespace hex {
         std::array<float, 256> m_valueCounts = { 0 };
         bool m_shouldInvalidate = false;
 
+        /* Runs while frames are drawn and has to be reset before the provider it analyzes gets deleted */
+        constexpr static auto AnalysisTimeBudget = std::chrono::milliseconds(5);
+        std::unique_ptr<ByteStatisticsJob> m_analysisJob;
+
         std::pair<u64, u64> m_analyzedRegion = { 0, 0 };
 
         std::string m_fileDescription;
         std::string m_mimeType;
+
+        void analyzeMagic(prv::Provider *provider);
+        void processAnalysis();
     };
 
 }
\ No newline at end of file
@@ -1,20 +1,19 @@
 #pragma once
 
 #include "views/view.hpp"
+#include "helpers/utils.hpp"
+#include "helpers/strings.hpp"
 
+#include <chrono>
 #include <cstdio>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace hex {
 
     namespace prv { class Provider; }
 
-    struct FoundString {
-        std::string string;
-        u64 offset;
-        size_t size;
-    };
-
     class ViewStrings : public View {
     public:
         explicit ViewStrings();
@@ -26,13 +25,46 @@ namespace hex {
     private:
         bool m_shouldInvalidate = false;
 
+        /* Runs while frames are drawn and has to be reset before the provider it extracts from gets deleted */
+        constexpr static auto ExtractionTimeBudget = std::chrono::milliseconds(5);
+        std::unique_ptr<StringExtractionJob> m_extractionJob;
+        bool m_shouldSort = false;
+
+        /* Order the table was last sorted in, the strings stay in order of their offset until then */
+        enum class SortColumn { Offset, Size, Encoding, String };
+        SortColumn m_sortColumn = SortColumn::Offset;
+        bool m_sortAscending = false;
+
         std::vector<FoundString> m_foundStrings;
+        StringTextCache m_textCache;
         int m_minimumLength = 5;
+        StringExtractionSettings m_extractionSettings;
         char *m_filter;
 
+        /* Changes up to this size get re-extracted right away on the UI thread */
+        constexpr static u64 MaxUpdateSize = 0x40'0000;
+
+        /* Strings appended by a running extraction get filtered once this many of them came in, each pass starts its own worker threads.
+         * Passes over the whole list after the filter changed start right away */
+        constexpr static size_t MinFilterBatchSize = 0x10000;
+
+        /* Indices of the strings matching the filter, the first m_filteredCount strings of the list have been filtered */
+        std::unique_ptr<StringFilterJob> m_filterJob;
+        std::vector<u64> m_filteredStrings;
+        size_t m_filteredCount = 0;
+
         std::string m_selectedString;
         std::string m_demangledName;
 
+        [[nodiscard]] StringExtractionSettings getExtractionSettings() const;
+        void processExtraction();
+        void processFilter(prv::Provider *provider);
+        void invalidateFilter();
+        /* Returns false if the change is too large to be handled in place, the strings have to be extracted again then */
+        bool updateStrings(const Region &region);
+        [[nodiscard]] bool isSortedBefore(prv::Provider *provider, const FoundString &left, const FoundString &right) const;
+        void sortStrings(prv::Provider *provider);
+
         void createStringContextMenu(const FoundString &foundString);
     };
 
@@ -7,6 +7,7 @@ namespace hex {
 
     enum class Events {
         FileLoaded,
+        ProviderClosing,
         DataChanged,
         PatternChanged,
         FileDropped,
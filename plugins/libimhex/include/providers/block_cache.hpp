@@ -0,0 +1,54 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace hex::prv {
+
+    /*
+     * Least recently used cache of fixed size blocks that sits in front of a provider's readRaw function.
+     * Meant for providers whose data is expensive to access, the mmap'd FileProvider doesn't need it.
+     */
+    class BlockCache {
+    public:
+        using ReadFunction = std::function<void(u64 offset, void *buffer, size_t size)>;
+
+        constexpr static size_t DefaultBlockSize    = 0x1'0000;
+        constexpr static size_t DefaultBlockCount   = 64;
+
+        explicit BlockCache(size_t blockSize = DefaultBlockSize, size_t maxBlockCount = DefaultBlockCount);
+
+        void read(u64 offset, void *buffer, size_t size, u64 dataSize, const ReadFunction &readFunction);
+        void invalidate(u64 offset, size_t size);
+        void clear();
+
+        [[nodiscard]] size_t getBlockSize() const       { return this->m_blockSize; }
+        [[nodiscard]] size_t getMaxBlockCount() const   { return this->m_maxBlockCount; }
+        [[nodiscard]] size_t getBlockCount() const      { return this->m_blocks.size(); }
+
+        [[nodiscard]] u64 getHitCount() const   { return this->m_hits; }
+        [[nodiscard]] u64 getMissCount() const  { return this->m_misses; }
+        void resetStatistics();
+
+    private:
+        struct Block {
+            u64 index;
+            std::vector<u8> data;
+        };
+
+        const Block& getBlock(u64 index, u64 dataSize, const ReadFunction &readFunction);
+
+        size_t m_blockSize;
+        size_t m_maxBlockCount;
+
+        std::list<Block> m_lruList;
+        std::unordered_map<u64, std::list<Block>::iterator> m_blocks;
+
+        u64 m_hits = 0, m_misses = 0;
+    };
+
+}
\ No newline at end of file
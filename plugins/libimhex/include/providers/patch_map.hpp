@@ -0,0 +1,49 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace hex::prv {
+
+    /*
+     * Stores patched bytes as sorted, non-overlapping extents of contiguous data instead of one node per byte.
+     * Adjacent and overlapping writes get merged into a single extent so reads can copy whole runs at once.
+     */
+    class PatchMap {
+    public:
+        using Extents = std::map<u64, std::vector<u8>>;
+
+        PatchMap() = default;
+        explicit PatchMap(const std::map<u64, u8> &patches);
+
+        void write(u64 address, const void *buffer, size_t size);
+        void erase(u64 address, size_t size = 1);
+        void clear();
+
+        void overlay(u64 offset, void *buffer, size_t size) const;
+        [[nodiscard]] bool overlaps(u64 offset, size_t size) const;
+
+        [[nodiscard]] std::optional<u8> get(u64 address) const;
+        [[nodiscard]] bool contains(u64 address) const;
+
+        [[nodiscard]] size_t size() const { return this->m_patchedBytes; }
+        [[nodiscard]] bool empty() const { return this->m_extents.empty(); }
+
+        [[nodiscard]] const Extents& getExtents() const { return this->m_extents; }
+        [[nodiscard]] Extents::const_iterator begin() const { return this->m_extents.begin(); }
+        [[nodiscard]] Extents::const_iterator end() const { return this->m_extents.end(); }
+
+        [[nodiscard]] PatchMap slice(u64 offset, size_t size) const;
+        [[nodiscard]] std::map<u64, u8> flatten() const;
+
+    private:
+        Extents::const_iterator findFirstOverlapping(u64 offset) const;
+
+        Extents m_extents;
+        size_t m_patchedBytes = 0;
+    };
+
+}
\ No newline at end of file
@@ -2,18 +2,66 @@
 
 #include <hex.hpp>
 
+#include <array>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
 #include <helpers/shared_data.hpp>
+#include <helpers/utils.hpp>
+#include <providers/block_cache.hpp>
+#include <providers/patch_map.hpp>
 
 namespace hex::prv {
 
+    /*
+     * Read-only view of a range of provider data. Either points directly into the provider's own storage, optionally keeping
+     * that storage alive through an owner handle, or owns a buffer with the materialized (patched) bytes.
+     */
+    class DataView {
+    public:
+        DataView() = default;
+        explicit DataView(std::span<const u8> data, std::shared_ptr<const void> owner = nullptr) : m_owner(std::move(owner)), m_data(data) { }
+        explicit DataView(std::vector<u8> &&buffer) : m_buffer(std::move(buffer)), m_data(this->m_buffer) { }
+
+        DataView(const DataView&) = delete;
+        DataView(DataView &&other) noexcept = default;
+        DataView& operator=(const DataView&) = delete;
+        DataView& operator=(DataView &&other) noexcept = default;
+
+        [[nodiscard]] const u8* data() const    { return this->m_data.data(); }
+        [[nodiscard]] size_t size() const       { return this->m_data.size(); }
+        [[nodiscard]] bool empty() const        { return this->m_data.empty(); }
+        [[nodiscard]] bool isZeroCopy() const   { return this->m_buffer.empty() && !this->m_data.empty(); }
+
+        [[nodiscard]] auto begin() const { return this->m_data.begin(); }
+        [[nodiscard]] auto end() const   { return this->m_data.end(); }
+
+        [[nodiscard]] const u8& operator[](size_t index) const { return this->m_data[index]; }
+        [[nodiscard]] std::span<const u8> getSpan() const { return this->m_data; }
+
+    private:
+        std::shared_ptr<const void> m_owner;
+        std::vector<u8> m_buffer;
+        std::span<const u8> m_data;
+    };
+
+    /* Describes how data is about to be accessed so providers can tune readahead and how much of it they keep resident */
+    enum class AccessHint {
+        Normal,
+        Sequential,
+        Random
+    };
+
     class Provider {
     public:
-        constexpr static size_t PageSize = 0x1000'0000;
+        /* Patches closer together than this get written in one go together with the unmodified bytes in between */
+        constexpr static size_t PatchCoalesceGap        = 0x1000;
+        constexpr static size_t MaxPatchWriteSize       = 0x100'0000;
 
         Provider();
         virtual ~Provider() = default;
@@ -25,27 +73,107 @@ namespace hex::prv {
         virtual void read(u64 offset, void *buffer, size_t size);
         virtual void write(u64 offset, const void *buffer, size_t size);
 
+        virtual DataView getView(u64 offset, size_t size);
+
+        /* Ranges that actually contain data, everything in between reads as zeros. Extents get grown by margin bytes on both sides */
+        std::vector<Region> getDataExtents(u64 offset, size_t size, size_t margin = 0);
+
         virtual void readRaw(u64 offset, void *buffer, size_t size) = 0;
         virtual void writeRaw(u64 offset, const void *buffer, size_t size) = 0;
-        virtual size_t getActualSize() = 0;
+        virtual u64 getActualSize() = 0;
+        virtual std::vector<Region> getDataExtentsRaw(u64 offset, size_t size);
 
-        std::map<u64, u8>& getPatches();
+        PatchMap& getPatches();
         void applyPatches();
 
-        u32 getPageCount();
-        u32 getCurrentPage() const;
-        void setCurrentPage(u32 page);
+        /* Removes all patches within the region, the removal can be undone like any other edit */
+        void removePatches(u64 offset, size_t size);
+        virtual bool saveAs(const std::string &path);
 
-        virtual size_t getBaseAddress();
-        virtual size_t getSize();
-        virtual std::optional<u32> getPageOfAddress(u64 address);
+        /* Return the region covered by the undone or redone step */
+        Region undo();
+        Region redo();
+        [[nodiscard]] bool canUndo() const;
+        [[nodiscard]] bool canRedo() const;
+
+        void beginTransaction();
+        Region commitTransaction();
+
+        [[nodiscard]] BlockCache* getBlockCache();
+
+        /* Hint used while no ScopedAccessHint is held, getAccessHint() returns the one currently in effect */
+        void setAccessHint(AccessHint hint);
+        [[nodiscard]] AccessHint getAccessHint() const;
+        virtual void prefetch(u64 offset, size_t size);
+
+        virtual u64 getBaseAddress();
+        virtual u64 getSize();
+
+        /* Polled regularly, returns the regions whose data got changed from outside of ImHex since the last call */
+        virtual std::vector<Region> checkForChanges();
 
         virtual std::vector<std::pair<std::string, std::string>> getDataInformation() = 0;
 
     protected:
-        u32 m_currPage = 0;
+        void addPatch(u64 offset, const void *buffer, size_t size);
+
+        /* Providers with slow readRaw implementations can opt into caching. They have to invalidate the cache themselves if their data changes outside of writeRaw */
+        void enableBlockCache(size_t blockSize = BlockCache::DefaultBlockSize, size_t blockCount = BlockCache::DefaultBlockCount);
+        void invalidateBlockCache(u64 offset, size_t size);
+
+        /* Called whenever the access hint in effect changes */
+        virtual void applyAccessHint(AccessHint hint);
+
+        PatchMap m_patches;
+        std::optional<BlockCache> m_blockCache;
+        AccessHint m_accessHint = AccessHint::Normal;
+
+    private:
+        friend class ScopedAccessHint;
+
+        void updateAccessHint();
+
+        /* Number of ScopedAccessHints holding each hint, indexed by the hint */
+        std::array<u32, 3> m_accessHintHolders = { };
+        AccessHint m_defaultAccessHint = AccessHint::Normal;
+        std::mutex m_accessHintMutex;
+
+        /* Every edit only remembers the bytes it wrote and the patches it replaced, so the history grows with the size of the edits */
+        struct PatchJournalEntry {
+            u64 address;
+            size_t size;
+            std::vector<u8> data;   /* Empty if the entry removed the patches in its region */
+            PatchMap previous;
+        };
+
+        /* All writes done inside of one transaction get undone and redone together */
+        using PatchJournalStep = std::vector<PatchJournalEntry>;
+
+        static Region getStepRegion(const PatchJournalStep &step);
+        void addJournalEntry(PatchJournalEntry &&entry);
+
+        std::vector<PatchJournalStep> m_undoJournal;
+        std::vector<PatchJournalStep> m_redoJournal;
+
+        u32 m_transactionDepth = 0;
+        PatchJournalStep m_currTransaction;
+    };
+
+    /*
+     * Keeps an access hint in effect on a provider for as long as it exists. Any number of them may be held at once, sequential
+     * hints win over random ones and the provider goes back to its own hint once the last one is gone.
+     */
+    class ScopedAccessHint {
+    public:
+        ScopedAccessHint(Provider *provider, AccessHint hint);
+        ~ScopedAccessHint();
+
+        ScopedAccessHint(const ScopedAccessHint&) = delete;
+        ScopedAccessHint& operator=(const ScopedAccessHint&) = delete;
 
-        std::vector<std::map<u64, u8>> m_patches;
+    private:
+        Provider *m_provider;
+        AccessHint m_hint;
     };
 
 }
\ No newline at end of file
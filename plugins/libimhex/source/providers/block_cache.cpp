@@ -0,0 +1,103 @@
+#include "providers/block_cache.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace hex::prv {
+
+    BlockCache::BlockCache(size_t blockSize, size_t maxBlockCount)
+        : m_blockSize(std::max<size_t>(blockSize, 1)), m_maxBlockCount(std::max<size_t>(maxBlockCount, 1)) {
+
+    }
+
+    const BlockCache::Block& BlockCache::getBlock(u64 index, u64 dataSize, const ReadFunction &readFunction) {
+        if (auto it = this->m_blocks.find(index); it != this->m_blocks.end()) {
+            this->m_hits++;
+
+            // Move the block to the front of the list to mark it as most recently used
+            this->m_lruList.splice(this->m_lruList.begin(), this->m_lruList, it->second);
+            return *it->second;
+        }
+
+        this->m_misses++;
+
+        std::vector<u8> data;
+
+        // Evict the least recently used block and reuse its buffer
+        if (this->m_blocks.size() >= this->m_maxBlockCount) {
+            auto &leastRecentlyUsed = this->m_lruList.back();
+            data = std::move(leastRecentlyUsed.data);
+
+            this->m_blocks.erase(leastRecentlyUsed.index);
+            this->m_lruList.pop_back();
+        }
+
+        u64 blockOffset = index * this->m_blockSize;
+        data.resize(std::min<u64>(this->m_blockSize, dataSize - blockOffset));
+        readFunction(blockOffset, data.data(), data.size());
+
+        this->m_lruList.push_front({ index, std::move(data) });
+        this->m_blocks[index] = this->m_lruList.begin();
+
+        return this->m_lruList.front();
+    }
+
+    void BlockCache::read(u64 offset, void *buffer, size_t size, u64 dataSize, const ReadFunction &readFunction) {
+        if (buffer == nullptr || size == 0 || offset >= dataSize)
+            return;
+
+        size = std::min<u64>(size, dataSize - offset);
+
+        auto output = reinterpret_cast<u8*>(buffer);
+        while (size > 0) {
+            u64 index = offset / this->m_blockSize;
+            u64 offsetInBlock = offset % this->m_blockSize;
+
+            const auto &block = this->getBlock(index, dataSize, readFunction);
+            size_t copySize = std::min<u64>(size, block.data.size() - offsetInBlock);
+
+            std::memcpy(output, block.data.data() + offsetInBlock, copySize);
+
+            output += copySize;
+            offset += copySize;
+            size   -= copySize;
+        }
+    }
+
+    void BlockCache::invalidate(u64 offset, size_t size) {
+        if (size == 0)
+            return;
+
+        u64 firstIndex = offset / this->m_blockSize;
+        u64 lastIndex  = (offset + size - 1) / this->m_blockSize;
+
+        // Walk whichever is smaller, the range of affected blocks or the cached blocks themselves
+        if (lastIndex - firstIndex < this->m_blocks.size()) {
+            for (u64 index = firstIndex; index <= lastIndex; index++) {
+                if (auto it = this->m_blocks.find(index); it != this->m_blocks.end()) {
+                    this->m_lruList.erase(it->second);
+                    this->m_blocks.erase(it);
+                }
+            }
+        } else {
+            std::erase_if(this->m_blocks, [&, this](const auto &entry) {
+                if (entry.first < firstIndex || entry.first > lastIndex)
+                    return false;
+
+                this->m_lruList.erase(entry.second);
+                return true;
+            });
+        }
+    }
+
+    void BlockCache::clear() {
+        this->m_lruList.clear();
+        this->m_blocks.clear();
+    }
+
+    void BlockCache::resetStatistics() {
+        this->m_hits = 0;
+        this->m_misses = 0;
+    }
+
+}
\ No newline at end of file
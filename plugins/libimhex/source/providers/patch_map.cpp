@@ -0,0 +1,184 @@
+#include "providers/patch_map.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace hex::prv {
+
+    PatchMap::PatchMap(const std::map<u64, u8> &patches) {
+        for (const auto &[address, value] : patches)
+            this->write(address, &value, sizeof(u8));
+    }
+
+    PatchMap::Extents::const_iterator PatchMap::findFirstOverlapping(u64 offset) const {
+        auto it = this->m_extents.upper_bound(offset);
+
+        if (it != this->m_extents.begin()) {
+            auto prev = std::prev(it);
+            if (prev->first + prev->second.size() > offset)
+                return prev;
+        }
+
+        return it;
+    }
+
+    void PatchMap::write(u64 address, const void *buffer, size_t size) {
+        if (buffer == nullptr || size == 0)
+            return;
+
+        auto data = reinterpret_cast<const u8*>(buffer);
+        u64 end = address + size;
+
+        // Find the first extent that either overlaps the new data or directly touches it from the left
+        auto first = this->m_extents.upper_bound(address);
+        if (first != this->m_extents.begin()) {
+            auto prev = std::prev(first);
+            if (prev->first + prev->second.size() >= address)
+                first = prev;
+        }
+
+        // Fast path, the new data lies completely inside of an already existing extent
+        if (first != this->m_extents.end() && first->first <= address && first->first + first->second.size() >= end) {
+            std::memcpy(first->second.data() + (address - first->first), data, size);
+            return;
+        }
+
+        // Collect every extent that overlaps or is adjacent to the new data and merge them into one
+        auto last = first;
+        while (last != this->m_extents.end() && last->first <= end)
+            last++;
+
+        if (first == last) {
+            this->m_extents.emplace(address, std::vector<u8>(data, data + size));
+            this->m_patchedBytes += size;
+            return;
+        }
+
+        u64 mergedStart = std::min(address, first->first);
+        auto lastMerged = std::prev(last);
+        u64 mergedEnd = std::max(end, lastMerged->first + lastMerged->second.size());
+
+        std::vector<u8> suffix;
+        if (lastMerged->first + lastMerged->second.size() > end)
+            suffix.assign(lastMerged->second.end() - ((lastMerged->first + lastMerged->second.size()) - end), lastMerged->second.end());
+
+        for (auto it = first; it != last; it++)
+            this->m_patchedBytes -= it->second.size();
+
+        // Reuse the storage of the first extent if it starts before the new data to avoid copying its prefix
+        std::vector<u8> merged;
+        if (first->first < address) {
+            merged = std::move(first->second);
+            merged.resize(address - first->first);
+        }
+
+        this->m_extents.erase(first, last);
+
+        merged.reserve(mergedEnd - mergedStart);
+        merged.insert(merged.end(), data, data + size);
+        merged.insert(merged.end(), suffix.begin(), suffix.end());
+
+        this->m_patchedBytes += merged.size();
+        this->m_extents.emplace(mergedStart, std::move(merged));
+    }
+
+    void PatchMap::erase(u64 address, size_t size) {
+        if (size == 0)
+            return;
+
+        u64 end = address + size;
+
+        auto it = this->m_extents.upper_bound(address);
+        if (it != this->m_extents.begin() && std::prev(it)->first + std::prev(it)->second.size() > address)
+            it = std::prev(it);
+
+        while (it != this->m_extents.end() && it->first < end) {
+            u64 extentStart = it->first;
+            u64 extentEnd   = extentStart + it->second.size();
+
+            if (extentEnd > end) {
+                // Keep the part of the extent that lies behind the erased range
+                this->m_extents.emplace(end, std::vector<u8>(it->second.begin() + (end - extentStart), it->second.end()));
+            }
+
+            this->m_patchedBytes -= it->second.size();
+
+            if (extentStart < address) {
+                // Keep the part of the extent that lies in front of the erased range
+                it->second.resize(address - extentStart);
+                this->m_patchedBytes += it->second.size();
+                it++;
+            } else {
+                it = this->m_extents.erase(it);
+            }
+
+            if (extentEnd > end)
+                this->m_patchedBytes += extentEnd - end;
+        }
+    }
+
+    void PatchMap::clear() {
+        this->m_extents.clear();
+        this->m_patchedBytes = 0;
+    }
+
+    void PatchMap::overlay(u64 offset, void *buffer, size_t size) const {
+        if (buffer == nullptr || size == 0)
+            return;
+
+        u64 end = offset + size;
+
+        for (auto it = this->findFirstOverlapping(offset); it != this->m_extents.end() && it->first < end; it++) {
+            u64 copyStart = std::max(offset, it->first);
+            u64 copyEnd   = std::min(end, it->first + it->second.size());
+
+            std::memcpy(reinterpret_cast<u8*>(buffer) + (copyStart - offset), it->second.data() + (copyStart - it->first), copyEnd - copyStart);
+        }
+    }
+
+    bool PatchMap::overlaps(u64 offset, size_t size) const {
+        if (size == 0)
+            return false;
+
+        auto it = this->findFirstOverlapping(offset);
+        return it != this->m_extents.end() && it->first < offset + size;
+    }
+
+    std::optional<u8> PatchMap::get(u64 address) const {
+        auto it = this->findFirstOverlapping(address);
+        if (it == this->m_extents.end() || it->first > address)
+            return { };
+
+        return it->second[address - it->first];
+    }
+
+    bool PatchMap::contains(u64 address) const {
+        return this->get(address).has_value();
+    }
+
+    PatchMap PatchMap::slice(u64 offset, size_t size) const {
+        PatchMap result;
+        u64 end = offset + size;
+
+        for (auto it = this->findFirstOverlapping(offset); it != this->m_extents.end() && it->first < end; it++) {
+            u64 copyStart = std::max(offset, it->first);
+            u64 copyEnd   = std::min(end, it->first + it->second.size());
+
+            result.write(copyStart, it->second.data() + (copyStart - it->first), copyEnd - copyStart);
+        }
+
+        return result;
+    }
+
+    std::map<u64, u8> PatchMap::flatten() const {
+        std::map<u64, u8> result;
+
+        for (const auto &[address, bytes] : this->m_extents)
+            for (u64 i = 0; i < bytes.size(); i++)
+                result.emplace_hint(result.end(), address + i, bytes[i]);
+
+        return result;
+    }
+
+}
\ No newline at end of file
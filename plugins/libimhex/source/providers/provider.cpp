@@ -2,7 +2,9 @@
 
 #include <hex.hpp>
 
-#include <cmath>
+#include <algorithm>
+#include <cstdio>
+#include <limits>
 #include <map>
 #include <optional>
 #include <string>
@@ -10,57 +12,303 @@
 
 namespace hex::prv {
 
-    Provider::Provider() {
-        this->m_patches.emplace_back();
-    }
+    Provider::Provider() = default;
 
     void Provider::read(u64 offset, void *buffer, size_t size) {
-        this->readRaw(offset, buffer, size);
+        if (this->m_blockCache.has_value())
+            this->m_blockCache->read(offset, buffer, size, this->getActualSize(), [this](u64 offset, void *buffer, size_t size) {
+                this->readRaw(offset, buffer, size);
+            });
+        else
+            this->readRaw(offset, buffer, size);
+
+        this->m_patches.overlay(offset, buffer, size);
+    }
+
+    DataView Provider::getView(u64 offset, size_t size) {
+        std::vector<u8> buffer(size, 0x00);
+        this->read(offset, buffer.data(), buffer.size());
+
+        return DataView(std::move(buffer));
+    }
+
+    std::vector<Region> Provider::getDataExtentsRaw(u64 offset, size_t size) {
+        return { { offset, size } };
+    }
+
+    std::vector<Region> Provider::getDataExtents(u64 offset, size_t size, size_t margin) {
+        if (offset >= this->getSize() || size == 0)
+            return { };
+
+        size = std::min<u64>(size, this->getSize() - offset);
+        u64 end = offset + size;
+
+        // Patched bytes count as data even if they lie inside of a hole
+        std::vector<Region> extents = this->getDataExtentsRaw(offset, size);
+        for (const auto &[patchAddress, patch] : this->m_patches.slice(offset, size))
+            extents.push_back({ patchAddress, patch.size() });
+
+        std::sort(extents.begin(), extents.end(), [](const Region &left, const Region &right) { return left.address < right.address; });
+
+        std::vector<Region> result;
+        for (const auto &extent : extents) {
+            u64 extentStart = extent.address - std::min<u64>(margin, extent.address - offset);
+            u64 extentEnd   = std::min<u64>(end, extent.address + extent.size + margin);
+
+            if (!result.empty() && result.back().address + result.back().size >= extentStart)
+                result.back().size = std::max(result.back().address + result.back().size, extentEnd) - result.back().address;
+            else
+                result.push_back({ extentStart, extentEnd - extentStart });
+        }
+
+        return result;
     }
 
     void Provider::write(u64 offset, const void *buffer, size_t size) {
         this->writeRaw(offset, buffer, size);
+        this->invalidateBlockCache(offset, size);
     }
 
 
-    std::map<u64, u8>& Provider::getPatches() {
-        return this->m_patches.back();
+    PatchMap& Provider::getPatches() {
+        return this->m_patches;
     }
 
     void Provider::applyPatches() {
-        for (auto &[patchAddress, patch] : this->m_patches.back())
-            this->writeRaw(patchAddress, &patch, 1);
+        std::vector<u8> buffer;
+        u64 bufferAddress = 0;
+
+        auto flush = [&, this] {
+            if (buffer.empty())
+                return;
+
+            this->writeRaw(bufferAddress, buffer.data(), buffer.size());
+            this->invalidateBlockCache(bufferAddress, buffer.size());
+            buffer.clear();
+        };
+
+        for (const auto &[patchAddress, patch] : this->m_patches) {
+            u64 bufferEnd = bufferAddress + buffer.size();
+
+            if (!buffer.empty() && patchAddress - bufferEnd <= PatchCoalesceGap && buffer.size() + patch.size() <= MaxPatchWriteSize) {
+                // Fill the gap with the original data so both extents can be written with a single call
+                size_t gapSize = patchAddress - bufferEnd;
+                buffer.resize(buffer.size() + gapSize);
+                this->readRaw(bufferEnd, buffer.data() + buffer.size() - gapSize, gapSize);
+            } else {
+                flush();
+                bufferAddress = patchAddress;
+            }
+
+            buffer.insert(buffer.end(), patch.begin(), patch.end());
+        }
+
+        flush();
     }
 
-    u32 Provider::getPageCount() {
-        return std::ceil(this->getActualSize() / double(PageSize));
+    bool Provider::saveAs(const std::string &path) {
+        FILE *file = fopen(path.c_str(), "wb");
+        if (file == nullptr)
+            return false;
+
+        SCOPE_EXIT( fclose(file); );
+
+        std::vector<u8> buffer(MaxPatchWriteSize, 0x00);
+        for (u64 offset = 0; offset < this->getActualSize(); offset += buffer.size()) {
+            size_t bufferSize = std::min<u64>(buffer.size(), this->getActualSize() - offset);
+
+            this->read(offset, buffer.data(), bufferSize);
+            if (fwrite(buffer.data(), 1, bufferSize, file) != bufferSize)
+                return false;
+        }
+
+        return true;
     }
 
-    u32 Provider::getCurrentPage() const {
-        return this->m_currPage;
+    void Provider::addPatch(u64 offset, const void *buffer, size_t size) {
+        if (buffer == nullptr || size == 0)
+            return;
+
+        auto data = reinterpret_cast<const u8*>(buffer);
+
+        PatchJournalEntry entry = { offset, size, std::vector<u8>(data, data + size), this->m_patches.slice(offset, size) };
+        this->m_patches.write(offset, buffer, size);
+
+        this->addJournalEntry(std::move(entry));
+    }
+
+    void Provider::removePatches(u64 offset, size_t size) {
+        if (size == 0 || !this->m_patches.overlaps(offset, size))
+            return;
+
+        PatchJournalEntry entry = { offset, size, { }, this->m_patches.slice(offset, size) };
+        this->m_patches.erase(offset, size);
+
+        this->addJournalEntry(std::move(entry));
     }
 
-    void Provider::setCurrentPage(u32 page) {
-        if (page < getPageCount())
-            this->m_currPage = page;
+    void Provider::addJournalEntry(PatchJournalEntry &&entry) {
+        this->m_redoJournal.clear();
+
+        if (this->m_transactionDepth > 0)
+            this->m_currTransaction.push_back(std::move(entry));
+        else
+            this->m_undoJournal.push_back({ std::move(entry) });
     }
 
+    Region Provider::undo() {
+        if (!this->canUndo())
+            return { 0, 0 };
+
+        auto step = std::move(this->m_undoJournal.back());
+        this->m_undoJournal.pop_back();
+
+        for (auto entry = step.rbegin(); entry != step.rend(); entry++) {
+            this->m_patches.erase(entry->address, entry->size);
+            for (const auto &[address, patch] : entry->previous)
+                this->m_patches.write(address, patch.data(), patch.size());
+        }
 
-    size_t Provider::getBaseAddress() {
-        return PageSize * this->m_currPage;
+        Region region = getStepRegion(step);
+        this->m_redoJournal.push_back(std::move(step));
+
+        return region;
     }
 
-    size_t Provider::getSize() {
-        return std::min(this->getActualSize() - PageSize * this->m_currPage, PageSize);
+    Region Provider::redo() {
+        if (!this->canRedo())
+            return { 0, 0 };
+
+        auto step = std::move(this->m_redoJournal.back());
+        this->m_redoJournal.pop_back();
+
+        for (const auto &entry : step) {
+            if (entry.data.empty())
+                this->m_patches.erase(entry.address, entry.size);
+            else
+                this->m_patches.write(entry.address, entry.data.data(), entry.data.size());
+        }
+
+        Region region = getStepRegion(step);
+        this->m_undoJournal.push_back(std::move(step));
+
+        return region;
     }
 
-    std::optional<u32> Provider::getPageOfAddress(u64 address) {
-        u32 page = std::floor(address / double(PageSize));
+    bool Provider::canUndo() const {
+        return !this->m_undoJournal.empty();
+    }
 
-        if (page >= this->getPageCount())
-            return { };
+    bool Provider::canRedo() const {
+        return !this->m_redoJournal.empty();
+    }
+
+    BlockCache* Provider::getBlockCache() {
+        if (!this->m_blockCache.has_value())
+            return nullptr;
+
+        return &this->m_blockCache.value();
+    }
+
+    void Provider::enableBlockCache(size_t blockSize, size_t blockCount) {
+        this->m_blockCache.emplace(blockSize, blockCount);
+    }
+
+    void Provider::invalidateBlockCache(u64 offset, size_t size) {
+        if (this->m_blockCache.has_value())
+            this->m_blockCache->invalidate(offset, size);
+    }
+
+    void Provider::setAccessHint(AccessHint hint) {
+        std::scoped_lock lock(this->m_accessHintMutex);
+
+        this->m_defaultAccessHint = hint;
+        this->updateAccessHint();
+    }
+
+    void Provider::applyAccessHint(AccessHint hint) {
+        this->m_accessHint = hint;
+    }
+
+    /* Has to be called with the access hint mutex locked */
+    void Provider::updateAccessHint() {
+        AccessHint hint = this->m_defaultAccessHint;
+        if (this->m_accessHintHolders[u32(AccessHint::Sequential)] > 0)
+            hint = AccessHint::Sequential;
+        else if (this->m_accessHintHolders[u32(AccessHint::Random)] > 0)
+            hint = AccessHint::Random;
+
+        if (hint != this->m_accessHint)
+            this->applyAccessHint(hint);
+    }
+
+    AccessHint Provider::getAccessHint() const {
+        return this->m_accessHint;
+    }
+
+    void Provider::prefetch(u64, size_t) {
+
+    }
+
+    void Provider::beginTransaction() {
+        this->m_transactionDepth++;
+    }
+
+    Region Provider::commitTransaction() {
+        if (this->m_transactionDepth == 0)
+            return { 0, 0 };
+
+        this->m_transactionDepth--;
+
+        // Nested transactions get committed together with the outermost one
+        if (this->m_transactionDepth > 0 || this->m_currTransaction.empty())
+            return { 0, 0 };
+
+        Region region = getStepRegion(this->m_currTransaction);
+
+        this->m_undoJournal.push_back(std::move(this->m_currTransaction));
+        this->m_currTransaction.clear();
+
+        return region;
+    }
+
+    /* Entries only touch their own region, the patches they replaced lie within it as well */
+    Region Provider::getStepRegion(const PatchJournalStep &step) {
+        u64 start = std::numeric_limits<u64>::max();
+        u64 end = 0;
+        for (const auto &entry : step) {
+            start = std::min(start, entry.address);
+            end = std::max(end, entry.address + entry.size);
+        }
+
+        return { start, end - start };
+    }
+
+    u64 Provider::getBaseAddress() {
+        return 0x00;
+    }
+
+    u64 Provider::getSize() {
+        return this->getActualSize();
+    }
+
+    std::vector<Region> Provider::checkForChanges() {
+        return { };
+    }
+
+
+    ScopedAccessHint::ScopedAccessHint(Provider *provider, AccessHint hint) : m_provider(provider), m_hint(hint) {
+        std::scoped_lock lock(this->m_provider->m_accessHintMutex);
+
+        this->m_provider->m_accessHintHolders[u32(hint)]++;
+        this->m_provider->updateAccessHint();
+    }
+
+    ScopedAccessHint::~ScopedAccessHint() {
+        std::scoped_lock lock(this->m_provider->m_accessHintMutex);
 
-        return page;
+        this->m_provider->m_accessHintHolders[u32(this->m_hint)]--;
+        this->m_provider->updateAccessHint();
     }
 
 }
\ No newline at end of file
@@ -0,0 +1,521 @@
+#include "helpers/byte_regex.hpp"
+
+#include "helpers/utils.hpp"
+
+#include <bitset>
+#include <cctype>
+#include <limits>
+#include <map>
+
+namespace hex {
+
+    namespace {
+
+        constexpr u32 Unbounded = std::numeric_limits<u32>::max();
+        constexpr u32 MaxRepetitionCount = 1000;
+
+        struct ParseError {
+            std::string message;
+        };
+
+        struct Node {
+            enum class Type {
+                Set,
+                Concatenation,
+                Alternation,
+                Repetition
+            };
+
+            Type type;
+            std::bitset<256> set;
+            std::vector<Node> children;
+            u32 min = 1, max = 1;
+        };
+
+        class Parser {
+        public:
+            explicit Parser(std::string_view pattern) : m_pattern(pattern) { }
+
+            Node parse() {
+                auto node = this->parseAlternation();
+
+                if (!this->atEnd())
+                    throw ParseError { "Unmatched )" };
+
+                return node;
+            }
+
+        private:
+            [[nodiscard]] bool atEnd() const { return this->m_position >= this->m_pattern.size(); }
+            [[nodiscard]] char peek() const { return this->atEnd() ? '\0' : this->m_pattern[this->m_position]; }
+
+            char next() {
+                if (this->atEnd())
+                    throw ParseError { "Unexpected end of pattern" };
+
+                return this->m_pattern[this->m_position++];
+            }
+
+            Node parseAlternation() {
+                Node node = { Node::Type::Alternation, { }, { } };
+                node.children.push_back(this->parseConcatenation());
+
+                while (this->peek() == '|') {
+                    this->m_position++;
+                    node.children.push_back(this->parseConcatenation());
+                }
+
+                if (node.children.size() == 1)
+                    return std::move(node.children.front());
+
+                return node;
+            }
+
+            Node parseConcatenation() {
+                Node node = { Node::Type::Concatenation, { }, { } };
+
+                while (!this->atEnd() && this->peek() != '|' && this->peek() != ')')
+                    node.children.push_back(this->parseRepetition());
+
+                return node;
+            }
+
+            u32 parseCount() {
+                if (!std::isdigit(this->peek()))
+                    throw ParseError { "Invalid repetition count" };
+
+                u32 count = 0;
+                while (std::isdigit(this->peek())) {
+                    count = count * 10 + (this->next() - '0');
+
+                    if (count > MaxRepetitionCount)
+                        throw ParseError { hex::format("Repetition counts can't be bigger than %u", MaxRepetitionCount) };
+                }
+
+                return count;
+            }
+
+            Node parseRepetition() {
+                auto node = this->parseAtom();
+
+                while (true) {
+                    u32 min, max;
+                    switch (this->peek()) {
+                        case '*': min = 0; max = Unbounded; break;
+                        case '+': min = 1; max = Unbounded; break;
+                        case '?': min = 0; max = 1; break;
+                        case '{': break;
+                        default: return node;
+                    }
+
+                    if (this->next() == '{') {
+                        min = max = this->parseCount();
+
+                        if (this->peek() == ',') {
+                            this->m_position++;
+                            max = this->peek() == '}' ? Unbounded : this->parseCount();
+                        }
+
+                        if (this->next() != '}')
+                            throw ParseError { "Expected }" };
+                        if (min > max)
+                            throw ParseError { "Invalid repetition range" };
+                    }
+
+                    if (this->peek() == '?')
+                        throw ParseError { "Lazy quantifiers are not supported" };
+
+                    Node repetition = { Node::Type::Repetition, { }, { } };
+                    repetition.children.push_back(std::move(node));
+                    repetition.min = min;
+                    repetition.max = max;
+
+                    node = std::move(repetition);
+                }
+            }
+
+            std::bitset<256> parseEscape() {
+                std::bitset<256> set;
+
+                auto addRange = [&set](u8 from, u8 to) {
+                    for (u32 byte = from; byte <= to; byte++)
+                        set.set(byte);
+                };
+
+                char escaped = this->next();
+                switch (escaped) {
+                    case 'x': {
+                        u8 byte = 0;
+                        for (u8 i = 0; i < 2; i++) {
+                            char digit = this->next();
+                            if (!std::isxdigit(digit))
+                                throw ParseError { "Expected two hex digits after \\x" };
+
+                            byte = (byte << 4) | (std::isdigit(digit) ? digit - '0' : std::tolower(digit) - 'a' + 10);
+                        }
+                        set.set(byte);
+                        break;
+                    }
+                    case 'd': case 'D':
+                        addRange('0', '9');
+                        break;
+                    case 'w': case 'W':
+                        addRange('0', '9');
+                        addRange('A', 'Z');
+                        addRange('a', 'z');
+                        set.set('_');
+                        break;
+                    case 's': case 'S':
+                        for (u8 byte : { ' ', '\t', '\n', '\r', '\f', '\v' })
+                            set.set(byte);
+                        break;
+                    case 'n': set.set('\n'); break;
+                    case 'r': set.set('\r'); break;
+                    case 't': set.set('\t'); break;
+                    case 'f': set.set('\f'); break;
+                    case 'v': set.set('\v'); break;
+                    case 'a': set.set('\a'); break;
+                    case 'e': set.set(0x1B); break;
+                    case '0': set.set(0x00); break;
+                    default:
+                        if (std::isalnum(escaped))
+                            throw ParseError { hex::format("Unknown escape sequence \\%c", escaped) };
+
+                        set.set(u8(escaped));
+                        break;
+                }
+
+                if (escaped == 'D' || escaped == 'W' || escaped == 'S')
+                    set.flip();
+
+                return set;
+            }
+
+            std::bitset<256> parseClassByte() {
+                std::bitset<256> set;
+
+                if (char c = this->next(); c == '\\')
+                    set = this->parseEscape();
+                else
+                    set.set(u8(c));
+
+                return set;
+            }
+
+            std::bitset<256> parseClass() {
+                std::bitset<256> set;
+
+                bool negated = this->peek() == '^';
+                if (negated)
+                    this->m_position++;
+
+                // A ] right at the start is part of the class
+                bool first = true;
+                while (first || this->peek() != ']') {
+                    first = false;
+
+                    auto from = this->parseClassByte();
+
+                    if (this->peek() == '-' && this->m_position + 1 < this->m_pattern.size() && this->m_pattern[this->m_position + 1] != ']') {
+                        this->m_position++;
+                        auto to = this->parseClassByte();
+
+                        if (from.count() != 1 || to.count() != 1)
+                            throw ParseError { "Ranges can only be formed from single bytes" };
+
+                        u32 fromByte = 0, toByte = 0;
+                        while (!from.test(fromByte)) fromByte++;
+                        while (!to.test(toByte)) toByte++;
+
+                        if (fromByte > toByte)
+                            throw ParseError { "Invalid range in character class" };
+
+                        for (u32 byte = fromByte; byte <= toByte; byte++)
+                            set.set(byte);
+                    } else
+                        set |= from;
+                }
+
+                this->m_position++;
+
+                if (negated)
+                    set.flip();
+
+                return set;
+            }
+
+            Node parseAtom() {
+                Node node = { Node::Type::Set, { }, { } };
+
+                char c = this->next();
+                switch (c) {
+                    case '(':
+                        if (this->m_pattern.substr(this->m_position).starts_with("?:"))
+                            this->m_position += 2;
+
+                        node = this->parseAlternation();
+
+                        if (this->atEnd() || this->next() != ')')
+                            throw ParseError { "Unmatched (" };
+                        break;
+                    case '.':
+                        node.set.set();
+                        break;
+                    case '[':
+                        node.set = this->parseClass();
+                        break;
+                    case '\\':
+                        node.set = this->parseEscape();
+                        break;
+                    case '^': case '$':
+                        throw ParseError { "Anchors are not supported" };
+                    case '*': case '+': case '?': case '{':
+                        throw ParseError { hex::format("Nothing to repeat before %c", c) };
+                    default:
+                        node.set.set(u8(c));
+                        break;
+                }
+
+                return node;
+            }
+
+            std::string_view m_pattern;
+            size_t m_position = 0;
+        };
+
+        size_t getMaxLength(const Node &node) {
+            size_t length = 0;
+
+            switch (node.type) {
+                case Node::Type::Set:
+                    return 1;
+                case Node::Type::Concatenation:
+                    for (const auto &child : node.children)
+                        length += getMaxLength(child);
+                    break;
+                case Node::Type::Alternation:
+                    for (const auto &child : node.children)
+                        length = std::max(length, getMaxLength(child));
+                    break;
+                case Node::Type::Repetition:
+                    length = getMaxLength(node.children.front());
+                    if (length != 0)
+                        length = node.max == Unbounded ? ByteRegex::MaxMatchLength : length * node.max;
+                    break;
+            }
+
+            return std::min(length, ByteRegex::MaxMatchLength);
+        }
+
+        /* Thompson NFA, states either consume a byte of their set or branch to other states without consuming anything */
+        struct Nfa {
+            constexpr static u32 AcceptState = 0;
+
+            struct State {
+                std::bitset<256> set;
+                u32 next = AcceptState;
+                std::vector<u32> branches;
+            };
+
+            std::vector<State> states = { State{ } };
+
+            // Closures get computed for every transition of the DFA, so visited states are marked with the number of the closure
+            std::vector<u32> visited;
+            u32 closureCount = 0;
+
+            u32 addState(State state) {
+                if (this->states.size() >= ByteRegex::MaxNfaStateCount)
+                    throw ParseError { "Pattern is too complex" };
+
+                this->states.push_back(std::move(state));
+                return this->states.size() - 1;
+            }
+
+            /* Builds the states of node back to front and returns the first one, next is where the node continues */
+            u32 build(const Node &node, u32 next) {
+                switch (node.type) {
+                    case Node::Type::Set:
+                        return this->addState({ node.set, next, { } });
+                    case Node::Type::Concatenation:
+                        for (auto child = node.children.rbegin(); child != node.children.rend(); child++)
+                            next = this->build(*child, next);
+                        return next;
+                    case Node::Type::Alternation: {
+                        std::vector<u32> branches;
+                        for (const auto &child : node.children)
+                            branches.push_back(this->build(child, next));
+
+                        return this->addState({ { }, AcceptState, std::move(branches) });
+                    }
+                    case Node::Type::Repetition: {
+                        const auto &child = node.children.front();
+
+                        u32 start = next;
+                        if (node.max == Unbounded) {
+                            start = this->addState({ });
+                            u32 body = this->build(child, start);
+                            this->states[start].branches = { body, next };
+                        } else {
+                            for (u32 i = node.min; i < node.max; i++) {
+                                u32 body = this->build(child, start);
+                                start = this->addState({ { }, AcceptState, { body, next } });
+                            }
+                        }
+
+                        for (u32 i = 0; i < node.min; i++)
+                            start = this->build(child, start);
+
+                        return start;
+                    }
+                }
+
+                return next;
+            }
+
+            /* All states reachable without consuming a byte, only keeping the ones that consume bytes or accept */
+            std::vector<u32> closure(std::vector<u32> pending) {
+                std::vector<u32> result;
+
+                this->visited.resize(this->states.size(), 0);
+                this->closureCount++;
+
+                while (!pending.empty()) {
+                    u32 index = pending.back();
+                    pending.pop_back();
+
+                    if (this->visited[index] == this->closureCount)
+                        continue;
+                    this->visited[index] = this->closureCount;
+
+                    const auto &state = this->states[index];
+                    if (index == AcceptState || state.set.any())
+                        result.push_back(index);
+
+                    pending.insert(pending.end(), state.branches.begin(), state.branches.end());
+                }
+
+                std::sort(result.begin(), result.end());
+                return result;
+            }
+        };
+
+        /* Subset construction, with unanchored set to true the start states get added after every byte */
+        std::vector<u32> buildDfa(Nfa &nfa, const std::vector<u32> &start, bool unanchored, const std::array<u8, 256> &byteClasses, size_t classCount, u32 acceptingFlag) {
+            std::vector<u8> classBytes(classCount);
+            for (u32 byte = 0; byte < 256; byte++)
+                classBytes[byteClasses[byte]] = byte;
+
+            std::map<std::vector<u32>, u32> stateIds;
+            std::vector<std::vector<u32>> stateSets;
+            std::vector<u32> transitions;
+            std::vector<bool> accepting;
+
+            auto addState = [&](std::vector<u32> &&set) -> u32 {
+                if (auto it = stateIds.find(set); it != stateIds.end())
+                    return it->second;
+
+                if (stateSets.size() >= ByteRegex::MaxDfaStateCount)
+                    throw ParseError { "Pattern is too complex" };
+
+                u32 id = stateSets.size();
+                accepting.push_back(std::binary_search(set.begin(), set.end(), Nfa::AcceptState));
+                transitions.resize(transitions.size() + classCount, 0);
+
+                stateIds.emplace(set, id);
+                stateSets.push_back(std::move(set));
+
+                return id;
+            };
+
+            if (!unanchored)
+                addState({ });
+            addState(std::vector<u32>(start));
+
+            for (u32 id = 0; id < stateSets.size(); id++) {
+                for (size_t byteClass = 0; byteClass < classCount; byteClass++) {
+                    u8 byte = classBytes[byteClass];
+
+                    std::vector<u32> next;
+                    for (u32 index : stateSets[id]) {
+                        if (nfa.states[index].set.test(byte))
+                            next.push_back(nfa.states[index].next);
+                    }
+
+                    if (unanchored)
+                        next.insert(next.end(), start.begin(), start.end());
+
+                    u32 nextId = addState(nfa.closure(std::move(next)));
+                    transitions[id * classCount + byteClass] = nextId;
+                }
+            }
+
+            for (auto &transition : transitions)
+                transition = (transition * classCount) | (accepting[transition] ? acceptingFlag : 0);
+
+            return transitions;
+        }
+
+    }
+
+    std::optional<ByteRegex> ByteRegex::compile(std::string_view pattern, std::string &error) {
+        try {
+            auto root = Parser(pattern).parse();
+
+            Nfa nfa;
+            u32 startState = nfa.build(root, Nfa::AcceptState);
+            auto start = nfa.closure({ startState });
+
+            if (std::binary_search(start.begin(), start.end(), Nfa::AcceptState))
+                throw ParseError { "Pattern matches empty data" };
+
+            ByteRegex regex;
+            regex.m_maxMatchLength = getMaxLength(root);
+
+            // Bytes that are in exactly the same sets behave the same and share a column of the transition tables
+            std::map<std::vector<bool>, u8> classIds;
+            for (u32 byte = 0; byte < 256; byte++) {
+                std::vector<bool> signature;
+                for (const auto &state : nfa.states)
+                    if (state.set.any())
+                        signature.push_back(state.set.test(byte));
+
+                auto [it, inserted] = classIds.emplace(std::move(signature), classIds.size());
+                regex.m_byteClasses[byte] = it->second;
+            }
+            regex.m_classCount = classIds.size();
+
+            regex.m_matchTransitions  = buildDfa(nfa, start, false, regex.m_byteClasses, regex.m_classCount, AcceptingFlag);
+            regex.m_searchTransitions = buildDfa(nfa, start, true, regex.m_byteClasses, regex.m_classCount, AcceptingFlag);
+
+            std::vector<u8> startBytes;
+            for (u32 byte = 0; byte < 256; byte++) {
+                if (regex.m_searchTransitions[SearchStartState + regex.m_byteClasses[byte]] != SearchStartState)
+                    startBytes.push_back(byte);
+            }
+
+            if (startBytes.size() == 1)
+                regex.m_startByte = startBytes.front();
+
+            error.clear();
+            return regex;
+        } catch (const ParseError &parseError) {
+            error = parseError.message;
+            return std::nullopt;
+        }
+    }
+
+    bool ByteRegex::matchesZeros() const {
+        u32 state = MatchStartState * this->m_classCount;
+
+        for (size_t i = 0; i < this->m_maxMatchLength && state != DeadState; i++) {
+            u32 next = this->m_matchTransitions[state + this->m_byteClasses[0x00]];
+            if (next & AcceptingFlag)
+                return true;
+
+            state = next;
+        }
+
+        return false;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "helpers/byte_statistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace hex {
+
+    static float calculateEntropy(const std::array<u64, 256> &valueCounts, u64 numBytes) {
+        if (numBytes == 0)
+            return 0;
+
+        float entropy = 0;
+
+        for (u16 i = 0; i < 256; i++) {
+            float probability = float(valueCounts[i]) / numBytes;
+
+            if (probability > 0)
+                entropy -= (probability * std::log2(probability));
+        }
+
+        return entropy / 8;
+    }
+
+    ByteStatisticsJob::ByteStatisticsJob(prv::Provider *provider)
+        : ChunkedJob(provider, splitBlocks(provider, provider->getSize(), calculateBlockSize(provider->getSize())), [](std::span<const u8> data, const Chunk&, std::vector<u32> &result) {
+            result.resize(256, 0);
+
+            for (u8 byte : data)
+                result[byte]++;
+        }), m_size(provider->getSize()), m_blockSize(calculateBlockSize(m_size)) {
+
+    }
+
+    u64 ByteStatisticsJob::calculateBlockSize(u64 size) {
+        return std::max<u64>((size + BlockCount - 1) / BlockCount, 1);
+    }
+
+    std::vector<ByteStatisticsJob::Chunk> ByteStatisticsJob::splitBlocks(prv::Provider *provider, u64 size, u64 blockSize) {
+        std::vector<Chunk> chunks;
+
+        // Chunks never cross the end of a block so each of them only adds to a single block
+        for (const auto &extent : provider->getDataExtents(0x00, size)) {
+            const u64 extentEnd = extent.address + extent.size;
+
+            for (u64 offset = extent.address; offset < extentEnd;) {
+                const u64 blockEnd = (offset / blockSize + 1) * blockSize;
+                const u64 chunkEnd = std::min({ extentEnd, blockEnd, offset + ChunkSize });
+
+                chunks.push_back({ offset, chunkEnd - offset, chunkEnd - offset });
+                offset = chunkEnd;
+            }
+        }
+
+        return chunks;
+    }
+
+    void ByteStatisticsJob::finishBlocks(u64 endBlock) {
+        for (; this->m_currentBlock < endBlock; this->m_currentBlock++) {
+            const u64 blockSize = std::min(this->m_blockSize, this->m_size - this->m_currentBlock * this->m_blockSize);
+
+            // Everything in the block that wasn't read lies in a hole
+            const u64 readSize = std::accumulate(this->m_blockValueCounts.begin(), this->m_blockValueCounts.end(), u64(0));
+            this->m_blockValueCounts[0x00] += blockSize - readSize;
+
+            this->m_blockEntropy.push_back(calculateEntropy(this->m_blockValueCounts, blockSize));
+
+            for (u16 i = 0; i < 256; i++)
+                this->m_valueCounts[i] += this->m_blockValueCounts[i];
+            this->m_blockValueCounts.fill(0);
+        }
+    }
+
+    bool ByteStatisticsJob::takeResults() {
+        bool done = this->takeChunks([this](const Chunk &chunk, std::vector<u32> &counts) {
+            this->finishBlocks(chunk.address / this->m_blockSize);
+
+            for (u16 i = 0; i < counts.size(); i++)
+                this->m_blockValueCounts[i] += counts[i];
+        });
+
+        if (done)
+            this->finishBlocks((this->m_size + this->m_blockSize - 1) / this->m_blockSize);
+
+        return done;
+    }
+
+    float ByteStatisticsJob::getAverageEntropy() const {
+        return calculateEntropy(this->m_valueCounts, this->m_size);
+    }
+
+}
\ No newline at end of file
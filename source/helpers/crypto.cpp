@@ -10,9 +10,46 @@
 
 #include <array>
 #include <span>
+#include <vector>
 
 namespace hex {
 
+    template<typename Func>
+    static void processDataChunks(prv::Provider* &data, u64 offset, size_t size, Func &&callback) {
+        constexpr static size_t ChunkSize = 0x10'0000;
+
+        prv::ScopedAccessHint accessHint(data, prv::AccessHint::Sequential);
+
+        if (offset >= data->getSize())
+            return;
+
+        u64 end = offset + std::min<u64>(size, data->getSize() - offset);
+
+        // Holes in sparse files read as zeros, feed them from a static buffer instead of going through the file
+        static const std::vector<u8> zeros(ChunkSize, 0x00);
+        auto processHole = [&](u64 holeSize) {
+            for (u64 chunkOffset = 0; chunkOffset < holeSize; chunkOffset += ChunkSize)
+                callback(zeros.data(), std::min(u64(ChunkSize), holeSize - chunkOffset));
+        };
+
+        u64 position = offset;
+        for (const auto &extent : data->getDataExtents(offset, end - offset)) {
+            processHole(extent.address - position);
+
+            for (u64 chunkOffset = 0; chunkOffset < extent.size; chunkOffset += ChunkSize) {
+                auto view = data->getView(extent.address + chunkOffset, std::min(u64(ChunkSize), extent.size - chunkOffset));
+                if (view.empty())
+                    return;
+
+                callback(view.data(), view.size());
+            }
+
+            position = extent.address + extent.size;
+        }
+
+        processHole(end - position);
+    }
+
     u16 crc16(prv::Provider* &data, u64 offset, size_t size, u16 polynomial, u16 init) {
         const auto table = [polynomial] {
             std::array<u16, 256> table;
@@ -38,16 +75,11 @@ namespace hex {
 
         u16 crc = init;
 
-        std::array<u8, 512> buffer = { 0 };
-
-        for (u64 bufferOffset = 0; offset < size; offset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-
+        processDataChunks(data, offset, size, [&](const u8 *buffer, size_t readSize) {
             for (size_t i = 0; i < readSize; i++) {
                 crc = (crc >> 8) ^ table[(crc ^ u16(buffer[i])) & 0x00FF];
             }
-        }
+        });
 
         return crc;
     }
@@ -71,16 +103,12 @@ namespace hex {
         }();
 
         uint32_t c = init;
-        std::array<u8, 512> buffer = { 0 };
-
-        for (u64 bufferOffset = 0; offset < size; offset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
 
+        processDataChunks(data, offset, size, [&](const u8 *buffer, size_t readSize) {
             for (size_t i = 0; i < readSize; i++) {
                 c = table[(c ^ buffer[i]) & 0xFF] ^ (c >> 8);
             }
-        }
+        });
 
         return ~c;
     }
@@ -92,12 +120,9 @@ namespace hex {
 
         MD4_Init(&ctx);
 
-        std::array<u8, 512> buffer = { 0 };
-        for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            MD4_Update(&ctx, buffer.data(), readSize);
-        }
+        processDataChunks(data, offset, size, [&ctx](const u8 *buffer, size_t readSize) {
+            MD4_Update(&ctx, buffer, readSize);
+        });
 
         MD4_Final(reinterpret_cast<u8*>(result.data()), &ctx);
 
@@ -111,12 +136,9 @@ namespace hex {
 
         MD5_Init(&ctx);
 
-        std::array<u8, 512> buffer = { 0 };
-        for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            MD5_Update(&ctx, buffer.data(), readSize);
-        }
+        processDataChunks(data, offset, size, [&ctx](const u8 *buffer, size_t readSize) {
+            MD5_Update(&ctx, buffer, readSize);
+        });
 
         MD5_Final(reinterpret_cast<u8*>(result.data()), &ctx);
 
@@ -129,12 +151,9 @@ namespace hex {
         SHA_CTX ctx;
 
         SHA1_Init(&ctx);
-        std::array<u8, 512> buffer = { 0 };
-        for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            SHA1_Update(&ctx, buffer.data(), readSize);
-        }
+        processDataChunks(data, offset, size, [&ctx](const u8 *buffer, size_t readSize) {
+            SHA1_Update(&ctx, buffer, readSize);
+        });
 
         SHA1_Final(reinterpret_cast<u8*>(result.data()), &ctx);
 
@@ -148,12 +167,9 @@ namespace hex {
 
         SHA224_Init(&ctx);
 
-        std::array<u8, 512> buffer = { 0 };
-        for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            SHA224_Update(&ctx, buffer.data(), readSize);
-        }
+        processDataChunks(data, offset, size, [&ctx](const u8 *buffer, size_t readSize) {
+            SHA224_Update(&ctx, buffer, readSize);
+        });
 
         SHA224_Final(reinterpret_cast<u8*>(result.data()), &ctx);
 
@@ -167,12 +183,9 @@ namespace hex {
 
         SHA256_Init(&ctx);
 
-        std::array<u8, 512> buffer = { 0 };
-        for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            SHA256_Update(&ctx, buffer.data(), readSize);
-        }
+        processDataChunks(data, offset, size, [&ctx](const u8 *buffer, size_t readSize) {
+            SHA256_Update(&ctx, buffer, readSize);
+        });
 
         SHA256_Final(reinterpret_cast<u8*>(result.data()), &ctx);
 
@@ -186,12 +199,9 @@ namespace hex {
 
         SHA384_Init(&ctx);
 
-        std::array<u8, 512> buffer = { 0 };
-        for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            SHA384_Update(&ctx, buffer.data(), readSize);
-        }
+        processDataChunks(data, offset, size, [&ctx](const u8 *buffer, size_t readSize) {
+            SHA384_Update(&ctx, buffer, readSize);
+        });
 
         SHA384_Final(reinterpret_cast<u8*>(result.data()), &ctx);
 
@@ -205,12 +215,9 @@ namespace hex {
 
         SHA512_Init(&ctx);
 
-        std::array<u8, 512> buffer = { 0 };
-        for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            SHA512_Update(&ctx, buffer.data(), readSize);
-        }
+        processDataChunks(data, offset, size, [&ctx](const u8 *buffer, size_t readSize) {
+            SHA512_Update(&ctx, buffer, readSize);
+        });
 
         SHA512_Final(reinterpret_cast<u8*>(result.data()), &ctx);
 
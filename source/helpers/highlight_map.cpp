@@ -0,0 +1,102 @@
+#include "helpers/highlight_map.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <queue>
+
+namespace hex {
+
+    void HighlightMap::add(u64 address, size_t size, u32 color) {
+        if (size == 0)
+            return;
+
+        this->m_pending.push_back({ address, address + size, color });
+    }
+
+    void HighlightMap::build() {
+        auto &pending = this->m_pending;
+
+        // Ranges that are already flattened have priority over everything added afterwards
+        pending.insert(pending.begin(), this->m_intervals.begin(), this->m_intervals.end());
+        this->m_intervals.clear();
+
+        std::vector<size_t> order(pending.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](size_t left, size_t right) { return pending[left].start < pending[right].start; });
+
+        // Sweep over all range boundaries while keeping the ranges covering the current address ordered by priority
+        auto lowerPriority = [](const std::pair<size_t, u64> &left, const std::pair<size_t, u64> &right) { return left.first > right.first; };
+        std::priority_queue<std::pair<size_t, u64>, std::vector<std::pair<size_t, u64>>, decltype(lowerPriority)> active(lowerPriority);
+
+        u64 address = 0;
+        size_t next = 0;
+        while (next < order.size() || !active.empty()) {
+            if (active.empty())
+                address = std::max(address, pending[order[next]].start);
+
+            while (next < order.size() && pending[order[next]].start <= address) {
+                active.emplace(order[next], pending[order[next]].end);
+                next++;
+            }
+
+            while (!active.empty() && active.top().second <= address)
+                active.pop();
+
+            if (active.empty())
+                continue;
+
+            auto [index, end] = active.top();
+            if (next < order.size())
+                end = std::min(end, pending[order[next]].start);
+
+            u32 color = pending[index].color;
+            if (!this->m_intervals.empty() && this->m_intervals.back().end == address && this->m_intervals.back().color == color)
+                this->m_intervals.back().end = end;
+            else
+                this->m_intervals.push_back({ address, end, color });
+
+            address = end;
+        }
+
+        pending.clear();
+        pending.shrink_to_fit();
+    }
+
+    void HighlightMap::clear() {
+        this->m_pending.clear();
+        this->m_intervals.clear();
+    }
+
+    std::optional<u32> HighlightMap::find(u64 address) const {
+        size_t cursor = this->m_intervals.size();
+        return this->find(address, cursor);
+    }
+
+    std::optional<u32> HighlightMap::find(u64 address, size_t &cursor) const {
+        const auto &intervals = this->m_intervals;
+
+        // Most lookups hit the same interval as the last one or the one right after it
+        for (size_t i = cursor; i < intervals.size() && i < cursor + 2; i++) {
+            if (address < intervals[i].start)
+                break;
+
+            if (address < intervals[i].end) {
+                cursor = i;
+                return intervals[i].color;
+            }
+        }
+
+        auto it = std::upper_bound(intervals.begin(), intervals.end(), address, [](u64 address, const Interval &interval) { return address < interval.start; });
+        if (it == intervals.begin())
+            return { };
+
+        --it;
+        cursor = it - intervals.begin();
+
+        if (address < it->end)
+            return it->color;
+        else
+            return { };
+    }
+
+}
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "views/view.hpp"
 #include "helpers/utils.hpp"
 #include "providers/provider.hpp"
+#include "providers/memory_provider.hpp"
 
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
@@ -10,11 +11,16 @@
 
 #include <cstring>
 #include <filesystem>
+#include <new>
+#include <stdexcept>
 
 using namespace std::literals::string_literals;
 
 namespace hex {
 
+    /* Patches may grow memory buffers by at most this many bytes past their current end */
+    constexpr static u64 MaxPatchGrowth = 0x1000'0000;
+
     PyObject* LoaderScript::Py_getFilePath(PyObject *self, PyObject *args) {
         return PyUnicode_FromString(LoaderScript::s_filePath.c_str());
     }
@@ -34,12 +40,24 @@ namespace hex {
             return nullptr;
         }
 
-        if (address >= LoaderScript::s_dataProvider->getActualSize()) {
+        // Buffers in memory grow to fit whatever the script generates, within reason
+        const u64 size = LoaderScript::s_dataProvider->getActualSize();
+        bool resizable = dynamic_cast<prv::MemoryProvider*>(LoaderScript::s_dataProvider) != nullptr;
+        if (resizable ? (address > size + MaxPatchGrowth || u64(count) > size + MaxPatchGrowth - address) : address >= size) {
             PyErr_SetString(PyExc_IndexError, "address out of range");
             return nullptr;
         }
 
-        LoaderScript::s_dataProvider->write(address, patches, count);
+        // Exceptions must not escape into the interpreter
+        try {
+            LoaderScript::s_dataProvider->write(address, patches, count);
+        } catch (const std::bad_alloc&) {
+            PyErr_SetString(PyExc_IndexError, "not enough memory to grow the data to the patched address");
+            return nullptr;
+        } catch (const std::length_error&) {
+            PyErr_SetString(PyExc_IndexError, "not enough memory to grow the data to the patched address");
+            return nullptr;
+        }
 
         Py_RETURN_NONE;
     }
@@ -179,6 +197,9 @@ namespace hex {
     }
 
     bool LoaderScript::processFile(std::string_view scriptPath) {
+        if (LoaderScript::s_dataProvider == nullptr)
+            return false;
+
         Py_SetProgramName(Py_DecodeLocale(mainArgv[0], nullptr));
 
         if (std::filesystem::exists(std::filesystem::path(mainArgv[0]).parent_path().string() + "/lib/python" PYTHON_VERSION_MAJOR_MINOR))
@@ -216,8 +237,15 @@ namespace hex {
         }
 
         FILE *scriptFile = fopen(scriptPath.data(), "r");
+
+        // Apply all patches made by the script as one undo step
+        LoaderScript::s_dataProvider->beginTransaction();
         PyRun_SimpleFile(scriptFile, scriptPath.data());
 
+        Region changedRegion = LoaderScript::s_dataProvider->commitTransaction();
+        if (changedRegion.size > 0)
+            View::postEvent(Events::DataChanged, &changedRegion);
+
         fclose(scriptFile);
 
         Py_Finalize();
@@ -0,0 +1,287 @@
+#include "helpers/search.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+namespace hex {
+
+    SequenceMatcher::SequenceMatcher(std::vector<u8> sequence) : m_sequence(std::move(sequence)) {
+        const size_t length = this->m_sequence.size();
+        if (length < MinSkipTableLength)
+            return;
+
+        this->m_skipTable.fill(length);
+        for (size_t i = 0; i < length - 1; i++)
+            this->m_skipTable[this->m_sequence[i]] = length - 1 - i;
+    }
+
+    MaskedSequenceMatcher::MaskedSequenceMatcher(std::vector<u8> sequence, std::vector<u8> mask) : m_sequence(std::move(sequence)), m_mask(std::move(mask)) {
+        this->m_mask.resize(this->m_sequence.size(), 0xFF);
+
+        for (size_t i = 0; i < this->m_sequence.size(); i++) {
+            this->m_sequence[i] &= this->m_mask[i];
+
+            if (!this->m_anchor.has_value() && this->m_mask[i] == 0xFF)
+                this->m_anchor = i;
+        }
+    }
+
+    bool MaskedSequenceMatcher::matchesZeros() const {
+        return std::all_of(this->m_sequence.begin(), this->m_sequence.end(), [](u8 byte) { return byte == 0x00; });
+    }
+
+    MultiSequenceMatcher::MultiSequenceMatcher(const std::vector<std::vector<u8>> &sequences) {
+        constexpr static u32 NoState = std::numeric_limits<u32>::max();
+
+        // Class 0 is shared by all bytes that aren't part of any sequence
+        for (const auto &sequence : sequences) {
+            for (u8 byte : sequence) {
+                if (this->m_byteClasses[byte] == 0)
+                    this->m_byteClasses[byte] = this->m_classCount++;
+            }
+        }
+
+        const size_t classCount = this->m_classCount;
+
+        // Build the trie of all sequences
+        std::vector<std::vector<u32>> stateOutputs(1);
+        this->m_transitions.assign(classCount, NoState);
+
+        for (u32 index = 0; index < sequences.size(); index++) {
+            const auto &sequence = sequences[index];
+
+            this->m_lengths.push_back(sequence.size());
+            this->m_maxLength = std::max(this->m_maxLength, sequence.size());
+
+            if (sequence.empty())
+                continue;
+
+            if (std::all_of(sequence.begin(), sequence.end(), [](u8 byte) { return byte == 0x00; }))
+                this->m_matchesZeros = true;
+
+            u32 state = 0;
+            for (u8 byte : sequence) {
+                auto &next = this->m_transitions[state * classCount + this->m_byteClasses[byte]];
+                if (next == NoState) {
+                    next = stateOutputs.size();
+                    stateOutputs.emplace_back();
+                    this->m_transitions.resize(this->m_transitions.size() + classCount, NoState);
+                }
+
+                state = this->m_transitions[state * classCount + this->m_byteClasses[byte]];
+            }
+
+            stateOutputs[state].push_back(index);
+        }
+
+        // Turn the trie into an automaton by following failure links breadth first, missing transitions get taken from the failure state
+        std::vector<u32> failure(stateOutputs.size(), 0);
+        std::deque<u32> queue;
+
+        for (size_t byteClass = 0; byteClass < classCount; byteClass++) {
+            auto &next = this->m_transitions[byteClass];
+            if (next == NoState)
+                next = 0;
+            else
+                queue.push_back(next);
+        }
+
+        while (!queue.empty()) {
+            u32 state = queue.front();
+            queue.pop_front();
+
+            for (size_t byteClass = 0; byteClass < classCount; byteClass++) {
+                u32 fallback = this->m_transitions[failure[state] * classCount + byteClass];
+                auto &next = this->m_transitions[state * classCount + byteClass];
+
+                if (next == NoState) {
+                    next = fallback;
+                } else {
+                    failure[next] = fallback;
+
+                    // Sequences ending in the failure state are suffixes and match here as well
+                    auto &outputs = stateOutputs[next];
+                    outputs.insert(outputs.end(), stateOutputs[fallback].begin(), stateOutputs[fallback].end());
+
+                    queue.push_back(next);
+                }
+            }
+        }
+
+        this->m_outputOffsets.reserve(stateOutputs.size() + 1);
+        for (const auto &outputs : stateOutputs) {
+            this->m_outputOffsets.push_back(this->m_outputs.size());
+            this->m_outputs.insert(this->m_outputs.end(), outputs.begin(), outputs.end());
+        }
+        this->m_outputOffsets.push_back(this->m_outputs.size());
+    }
+
+    SearchJob::SearchJob(prv::Provider *provider, const std::vector<Region> &extents, size_t maxMatchLength, ChunkMatcher matcher, bool overlappingMatches)
+        : ChunkedJob(provider, extents, std::max<size_t>(maxMatchLength, 1) - 1, [matcher](std::span<const u8> data, const Chunk &chunk, SearchResultList &results) {
+              matcher(data, chunk.searchSize, chunk.address, results);
+          }),
+          m_matcher(std::move(matcher)), m_maxMatchLength(std::max<size_t>(maxMatchLength, 1)), m_overlappingMatches(overlappingMatches) {
+
+    }
+
+    void SearchJob::takeResults(SearchResultList &results) {
+        this->takeChunks([&, this](const Chunk &chunk, const SearchResultList &chunkResults) {
+            if (this->m_overlappingMatches)
+                results.append(chunkResults);
+            else
+                this->stitchResults(chunk, chunkResults, results);
+        });
+    }
+
+    void SearchJob::stitchResults(const Chunk &chunk, const SearchResultList &chunkResults, SearchResultList &results) {
+        const u64 searchEnd = chunk.address + chunk.searchSize;
+
+        u64 position = std::max(this->m_matchesEnd, chunk.address);
+        u64 previousEnd = chunk.address;
+        size_t index = 0;
+
+        while (true) {
+            while (index < chunkResults.size()) {
+                auto result = chunkResults.get(index);
+                if (result.start >= position)
+                    break;
+
+                previousEnd = result.end;
+                index++;
+            }
+
+            // Once the position isn't inside of a match found by the chunk, both agree on all following matches
+            if (previousEnd <= position || position >= searchEnd)
+                break;
+
+            // The first match from the position on starts at the latest where the chunk's next match does
+            u64 limit = index < chunkResults.size() ? chunkResults.get(index).start + 1 : searchEnd;
+            u64 readEnd = std::min<u64>(limit + this->m_maxMatchLength - 1, chunk.address + chunk.size);
+
+            std::vector<u8> buffer(readEnd - position);
+            this->m_provider->read(position, buffer.data(), buffer.size());
+
+            SearchResultList rematched;
+            this->m_matcher(buffer, limit - position, position, rematched);
+
+            if (rematched.empty())
+                break;
+
+            auto result = rematched.get(0);
+            results.add(result);
+            position = this->m_matchesEnd = result.end;
+        }
+
+        chunkResults.forEach(index, chunkResults.size() - index, [&, this](size_t, const SearchResult &result) {
+            if (result.start < position)
+                return;
+
+            results.add(result);
+            this->m_matchesEnd = result.end;
+        });
+    }
+
+    std::unique_ptr<SearchJob> searchSequence(prv::Provider *provider, const std::vector<u8> &sequence) {
+        if (sequence.empty() || !provider->isReadable())
+            return std::make_unique<SearchJob>(provider, std::vector<Region>{ }, 0, nullptr);
+
+        u64 dataSize = provider->getSize();
+
+        // Holes in sparse files only contain zeros, so unless that's what's being searched for only the data around them needs to be looked at
+        std::vector<Region> extents = { { 0x00, dataSize } };
+        if (std::any_of(sequence.begin(), sequence.end(), [](u8 byte) { return byte != 0x00; }))
+            extents = provider->getDataExtents(0x00, dataSize, sequence.size() - 1);
+
+        SequenceMatcher matcher(sequence);
+
+        return std::make_unique<SearchJob>(provider, extents, sequence.size(), [matcher](std::span<const u8> data, size_t searchSize, u64 address, SearchResultList &results) {
+            matcher.find(data, [&](size_t offset) {
+                if (offset >= searchSize)
+                    return false;
+
+                results.add({ address + offset, address + offset + matcher.getLength(), 0 });
+                return true;
+            });
+        });
+    }
+
+    std::unique_ptr<SearchJob> searchMaskedSequence(prv::Provider *provider, const std::vector<u8> &sequence, const std::vector<u8> &mask) {
+        if (sequence.empty() || !provider->isReadable())
+            return std::make_unique<SearchJob>(provider, std::vector<Region>{ }, 0, nullptr);
+
+        MaskedSequenceMatcher matcher(sequence, mask);
+
+        u64 dataSize = provider->getSize();
+
+        std::vector<Region> extents = { { 0x00, dataSize } };
+        if (!matcher.matchesZeros())
+            extents = provider->getDataExtents(0x00, dataSize, sequence.size() - 1);
+
+        return std::make_unique<SearchJob>(provider, extents, sequence.size(), [matcher](std::span<const u8> data, size_t searchSize, u64 address, SearchResultList &results) {
+            matcher.find(data, [&](size_t offset) {
+                if (offset >= searchSize)
+                    return false;
+
+                results.add({ address + offset, address + offset + matcher.getLength(), 0 });
+                return true;
+            });
+        });
+    }
+
+
+    std::unique_ptr<SearchJob> searchMultipleSequences(prv::Provider *provider, const std::vector<std::vector<u8>> &sequences) {
+        auto matcher = std::make_shared<MultiSequenceMatcher>(sequences);
+
+        if (matcher->getMaxLength() == 0 || !provider->isReadable())
+            return std::make_unique<SearchJob>(provider, std::vector<Region>{ }, 0, nullptr);
+
+        u64 dataSize = provider->getSize();
+
+        std::vector<Region> extents = { { 0x00, dataSize } };
+        if (!matcher->matchesZeros())
+            extents = provider->getDataExtents(0x00, dataSize, matcher->getMaxLength() - 1);
+
+        return std::make_unique<SearchJob>(provider, extents, matcher->getMaxLength(), [matcher](std::span<const u8> data, size_t searchSize, u64 address, SearchResultList &results) {
+            std::vector<SearchResult> matches;
+            matcher->find(data, [&](size_t offset, u32 sequence) {
+                if (offset < searchSize)
+                    matches.push_back({ address + offset, address + offset + matcher->getLength(sequence), sequence });
+                return true;
+            });
+
+            // Matches get found in order of their end, results are expected in order of their start
+            std::sort(matches.begin(), matches.end(), [](const auto &left, const auto &right) {
+                return std::tie(left.start, left.pattern) < std::tie(right.start, right.pattern);
+            });
+
+            for (const auto &match : matches)
+                results.add(match);
+        });
+    }
+
+    std::unique_ptr<SearchJob> searchRegex(prv::Provider *provider, const ByteRegex &regex) {
+        if (!provider->isReadable())
+            return std::make_unique<SearchJob>(provider, std::vector<Region>{ }, 0, nullptr);
+
+        auto matcher = std::make_shared<ByteRegex>(regex);
+
+        u64 dataSize = provider->getSize();
+
+        std::vector<Region> extents = { { 0x00, dataSize } };
+        if (!matcher->matchesZeros())
+            extents = provider->getDataExtents(0x00, dataSize, matcher->getMaxMatchLength() - 1);
+
+        // Matches don't overlap, so the ones reaching into the next chunk get fixed up while taking the results
+        return std::make_unique<SearchJob>(provider, extents, matcher->getMaxMatchLength(), [matcher](std::span<const u8> data, size_t searchSize, u64 address, SearchResultList &results) {
+            matcher->find(data, [&](size_t offset, size_t length) {
+                if (offset >= searchSize)
+                    return false;
+
+                results.add({ address + offset, address + offset + length, 0 });
+                return true;
+            });
+        }, false);
+    }
+
+}
\ No newline at end of file
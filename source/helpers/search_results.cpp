@@ -0,0 +1,130 @@
+#include "helpers/search_results.hpp"
+
+#include <algorithm>
+
+namespace hex {
+
+    static void encodeVarInt(std::vector<u8> &data, u64 value) {
+        while (value >= 0x80) {
+            data.push_back(u8(value) | 0x80);
+            value >>= 7;
+        }
+
+        data.push_back(u8(value));
+    }
+
+    static u64 decodeVarInt(const std::vector<u8> &data, size_t &position) {
+        u64 value = 0;
+        for (u32 shift = 0; position < data.size(); shift += 7) {
+            u8 byte = data[position++];
+            value |= u64(byte & 0x7F) << shift;
+
+            if ((byte & 0x80) == 0)
+                break;
+        }
+
+        return value;
+    }
+
+    void SearchResultList::decode(const Block &block, size_t &position, SearchResult &result) {
+        // The lowest bit marks results whose size or pattern differ from the previous one
+        u64 header = decodeVarInt(block.data, position);
+        u64 size = result.end - result.start;
+
+        result.start += header >> 1;
+
+        if (header & 1) {
+            size = decodeVarInt(block.data, position);
+            result.pattern = decodeVarInt(block.data, position);
+        }
+
+        result.end = result.start + size;
+    }
+
+    void SearchResultList::store(const SearchResult &result) {
+        if (this->m_blocks.empty() || this->m_blocks.back().count == BlockSize) {
+            this->m_blocks.push_back({ result.start, 0, { } });
+            this->m_last = { result.start, result.start, 0 };
+        }
+
+        auto &block = this->m_blocks.back();
+
+        bool changed = (result.end - result.start) != (this->m_last.end - this->m_last.start) || result.pattern != this->m_last.pattern;
+        encodeVarInt(block.data, ((result.start - this->m_last.start) << 1) | (changed ? 1 : 0));
+
+        if (changed) {
+            encodeVarInt(block.data, result.end - result.start);
+            encodeVarInt(block.data, result.pattern);
+        }
+
+        block.count++;
+        this->m_count++;
+        this->m_last = result;
+    }
+
+    void SearchResultList::add(const SearchResult &result) {
+        u64 resultIndex = this->m_totalCount++;
+
+        if (this->m_limit == 0 || this->m_count < this->m_limit) {
+            if (resultIndex % this->m_sampleStride == 0)
+                this->store(result);
+
+            return;
+        }
+
+        if (this->m_limitMode == LimitMode::Truncate)
+            return;
+
+        // Thin out the stored results by keeping every other one and only store every other result from now on
+        std::vector<Block> blocks;
+        std::swap(blocks, this->m_blocks);
+        this->m_count = 0;
+
+        size_t storedIndex = 0;
+        for (const auto &block : blocks) {
+            SearchResult decoded = { block.start, block.start, 0 };
+            size_t position = 0;
+
+            for (u32 i = 0; i < block.count; i++, storedIndex++) {
+                decode(block, position, decoded);
+
+                if (storedIndex % 2 == 0)
+                    this->store(decoded);
+            }
+        }
+
+        this->m_sampleStride *= 2;
+
+        if (resultIndex % this->m_sampleStride == 0)
+            this->store(result);
+    }
+
+    void SearchResultList::append(const SearchResultList &other) {
+        other.forEach(0, other.size(), [this](size_t, const SearchResult &result) {
+            this->add(result);
+        });
+    }
+
+    void SearchResultList::clear() {
+        this->m_blocks.clear();
+        this->m_count = 0;
+        this->m_totalCount = 0;
+        this->m_last = { };
+        this->m_sampleStride = 1;
+    }
+
+    void SearchResultList::setLimit(size_t limit, LimitMode mode) {
+        this->m_limit = limit;
+        this->m_limitMode = mode;
+    }
+
+    SearchResult SearchResultList::get(size_t index) const {
+        SearchResult result = { };
+        this->forEach(index, 1, [&result](size_t, const SearchResult &found) {
+            result = found;
+        });
+
+        return result;
+    }
+
+}
\ No newline at end of file
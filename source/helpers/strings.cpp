@@ -0,0 +1,498 @@
+#include "helpers/strings.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+namespace hex {
+
+    namespace {
+
+        constexpr u64 repeatByte(u8 byte) {
+            return 0x0101'0101'0101'0101ULL * byte;
+        }
+
+        constexpr u64 HighBits = repeatByte(0x80);
+
+        constexpr u64 AllBits  = 0xFFFF'FFFF'FFFF'FFFFULL;
+        constexpr u64 EvenBits = 0x5555'5555'5555'5555ULL;
+        constexpr u64 OddBits  = 0xAAAA'AAAA'AAAA'AAAAULL;
+
+        constexpr size_t BlockSize = 64;
+
+        /* Sets the top bit of every byte whose lower seven bits are at least value, bytes get compared without carrying into each other */
+        constexpr u64 getAtLeastMask(u64 lowBits, u8 value) {
+            return (lowBits + repeatByte(0x80 - value)) & HighBits;
+        }
+
+        /* Moves the top bits of all bytes into the lowest eight bits, in the order the bytes are in memory */
+        constexpr u64 gatherTopBits(u64 mask) {
+            return ((mask >> 7) * 0x0102'0408'1020'4080ULL) >> 56;
+        }
+
+        u64 loadLittleEndian(const u8 *data) {
+            u64 word = 0;
+
+            if constexpr (std::endian::native == std::endian::little) {
+                std::memcpy(&word, data, sizeof(u64));
+            } else {
+                for (u32 i = 0; i < sizeof(u64); i++)
+                    word |= u64(data[i]) << (i * 8);
+            }
+
+            return word;
+        }
+
+        /* One bit per byte of a block for each range of bytes the encodings are made of */
+        struct BlockMasks {
+            u64 printable = 0;
+            u64 latin1 = 0;
+            u64 zero = 0;
+            u64 lead = 0;
+        };
+
+        /* Classifies eight bytes at once, only the masks needed by the enabled encodings get calculated */
+        BlockMasks classifyBlock(const u8 *data, bool wide, bool utf8) {
+            BlockMasks masks;
+
+            for (u32 i = 0; i < BlockSize / sizeof(u64); i++) {
+                const u64 word = loadLittleEndian(data + i * sizeof(u64));
+                const u64 lowBits = word & repeatByte(0x7F);
+                const u64 high = word & HighBits;
+                const u64 atLeastSpace = getAtLeastMask(lowBits, 0x20);
+                const u32 shift = i * 8;
+
+                masks.printable |= gatherTopBits(atLeastSpace & ~getAtLeastMask(lowBits, 0x7F) & ~high) << shift;
+
+                if (wide) {
+                    masks.latin1 |= gatherTopBits(atLeastSpace & high) << shift;
+                    masks.zero   |= gatherTopBits(~getAtLeastMask(lowBits, 0x01) & ~high & HighBits) << shift;
+                }
+
+                // 0xC2 - 0xF4 may start a multi-byte UTF-8 sequence
+                if (utf8)
+                    masks.lead |= gatherTopBits(getAtLeastMask(lowBits, 0x42) & ~getAtLeastMask(lowBits, 0x75) & high) << shift;
+            }
+
+            return masks;
+        }
+
+        /* Length of the sequence starting with a lead byte, zero if it's invalid, overlong, a surrogate or a control character */
+        size_t getSequenceLength(const u8 *data) {
+            auto isContinuation = [](u8 byte) { return (byte & 0xC0) == 0x80; };
+
+            const u8 lead = data[0];
+            if (lead <= 0xDF)
+                return isContinuation(data[1]) && !(lead == 0xC2 && data[1] < 0xA0) ? 2 : 0;
+
+            u8 minimum = 0x80, maximum = 0xBF;
+            if (lead == 0xE0)       minimum = 0xA0;
+            else if (lead == 0xED)  maximum = 0x9F;
+            else if (lead == 0xF0)  minimum = 0x90;
+            else if (lead == 0xF4)  maximum = 0x8F;
+
+            if (data[1] < minimum || data[1] > maximum || !isContinuation(data[2]))
+                return 0;
+
+            if (lead <= 0xEF)
+                return 3;
+
+            return isContinuation(data[3]) ? 4 : 0;
+        }
+
+        /* Marks all bytes of the valid sequences starting at the leads, the bits of bytes in the next block end up in carry */
+        u64 validateUtf8(const u8 *data, u64 leads, u64 &carry) {
+            u64 valid = 0;
+            carry = 0;
+
+            while (leads != 0) {
+                u32 position = std::countr_zero(leads);
+                leads &= leads - 1;
+
+                size_t length = getSequenceLength(data + position);
+                if (length == 0)
+                    continue;
+
+                u64 sequence = (1ULL << length) - 1;
+                valid |= sequence << position;
+
+                if (position + length > BlockSize)
+                    carry |= sequence >> (BlockSize - position);
+            }
+
+            return valid;
+        }
+
+        /*
+         * Strings of one encoding at one alignment. UTF-16 characters are two bytes apart so the even and odd bytes are looked
+         * at separately, UTF-8 characters instead have a bit set for each of their bytes.
+         */
+        struct Lane {
+            StringEncoding encoding;
+            u32 stride;
+            u64 bits;
+            u32 firstBit;
+
+            bool inString = false;
+            size_t stringStart = 0;
+        };
+
+    }
+
+    const char* getStringEncodingName(StringEncoding encoding) {
+        switch (encoding) {
+            case StringEncoding::ASCII:   return "ASCII";
+            case StringEncoding::UTF8:    return "UTF-8";
+            case StringEncoding::UTF16LE: return "UTF-16LE";
+            case StringEncoding::UTF16BE: return "UTF-16BE";
+        }
+
+        return "";
+    }
+
+    bool finishString(PartialString &string, const StringExtractionSettings &settings) {
+        if (string.string.encoding == StringEncoding::UTF8 && string.length == string.string.size) {
+            if (!settings.ascii)
+                return false;
+
+            string.string.encoding = StringEncoding::ASCII;
+        }
+
+        return string.length >= std::max<size_t>(settings.minimumLength, 1);
+    }
+
+    std::string decodeString(std::span<const u8> data, StringEncoding encoding) {
+        if (encoding == StringEncoding::ASCII || encoding == StringEncoding::UTF8)
+            return std::string(data.begin(), data.end());
+
+        std::string string;
+        string.reserve(data.size() / 2);
+
+        for (size_t i = 0; i + 1 < data.size(); i += 2) {
+            u8 character = encoding == StringEncoding::UTF16LE ? data[i] : data[i + 1];
+
+            if (character < 0x80) {
+                string += char(character);
+            } else {
+                string += char(0xC0 | (character >> 6));
+                string += char(0x80 | (character & 0x3F));
+            }
+        }
+
+        return string;
+    }
+
+    std::string readString(prv::Provider *provider, const FoundString &string) {
+        std::vector<u8> bytes(string.size);
+        provider->read(string.offset, bytes.data(), bytes.size());
+
+        return decodeString(bytes, string.encoding);
+    }
+
+    const std::string& StringTextCache::get(prv::Provider *provider, const FoundString &string) {
+        Key key = { string.offset, string.size, string.encoding };
+
+        if (auto entry = this->m_lookup.find(key); entry != this->m_lookup.end()) {
+            this->m_entries.splice(this->m_entries.begin(), this->m_entries, entry->second);
+            return entry->second->second;
+        }
+
+        if (this->m_entries.size() >= Capacity) {
+            this->m_lookup.erase(this->m_entries.back().first);
+            this->m_entries.pop_back();
+        }
+
+        this->m_entries.emplace_front(key, readString(provider, string));
+        this->m_lookup[key] = this->m_entries.begin();
+
+        return this->m_entries.front().second;
+    }
+
+    void StringTextCache::clear() {
+        this->m_entries.clear();
+        this->m_lookup.clear();
+    }
+
+    void extractStrings(std::span<const u8> data, size_t searchSize, u64 address, const StringExtractionSettings &settings, ExtractedStrings &result) {
+        const u8 *bytes = data.data();
+        const size_t size = data.size();
+        searchSize = std::min(searchSize, size);
+
+        // UTF-8 strings include all ASCII ones, they're told apart once they're finished
+        std::vector<Lane> lanes;
+        if (settings.ascii && !settings.utf8)
+            lanes.push_back({ StringEncoding::ASCII, 1, AllBits, 0 });
+        if (settings.utf8)
+            lanes.push_back({ StringEncoding::UTF8, 1, AllBits, 0 });
+        for (auto [enabled, encoding] : { std::pair{ settings.utf16le, StringEncoding::UTF16LE }, std::pair{ settings.utf16be, StringEncoding::UTF16BE } }) {
+            if (!enabled)
+                continue;
+
+            lanes.push_back({ encoding, 2, EvenBits, 0 });
+            lanes.push_back({ encoding, 2, OddBits, 1 });
+        }
+
+        const bool wide = settings.utf16le || settings.utf16be;
+        const bool utf8 = settings.utf8;
+
+        auto toggleString = [&](Lane &lane, size_t position) {
+            lane.inString = !lane.inString;
+            if (lane.inString) {
+                lane.stringStart = position;
+                return;
+            }
+
+            const size_t stringSize = position - lane.stringStart;
+            const bool edge = lane.stringStart < MaxCharacterSize || position >= searchSize;
+
+            // Characters take up at least stride bytes, most runs are too short to be counted at all
+            if (!edge && stringSize / lane.stride < settings.minimumLength)
+                return;
+
+            u64 length = stringSize / lane.stride;
+            if (lane.encoding == StringEncoding::UTF8)
+                length = std::count_if(bytes + lane.stringStart, bytes + position, [](u8 byte) { return (byte & 0xC0) != 0x80; });
+
+            PartialString string = { { address + lane.stringStart, u32(stringSize), lane.encoding }, length };
+
+            if (edge)
+                result.edgeStrings.push_back(string);
+            else if (finishString(string, settings))
+                result.strings.push_back(string.string);
+        };
+
+        // Characters starting at the end of the search size may take up to MaxCharacterSize - 1 more bytes
+        const size_t scanEnd = std::min(size, searchSize + MaxCharacterSize - 1);
+
+        u64 utf8Carry = 0;
+        size_t offset = 0;
+        for (; offset < scanEnd; offset += BlockSize) {
+            // The last blocks get padded with DEL, which isn't part of a character in any of the encodings
+            std::array<u8, BlockSize + MaxCharacterSize> padded;
+            const u8 *block = bytes + offset;
+            if (offset + padded.size() > size) {
+                padded.fill(0x7F);
+                std::memcpy(padded.data(), block, std::min(size - offset, padded.size()));
+                block = padded.data();
+            }
+
+            const auto masks = classifyBlock(block, wide, utf8);
+
+            // Only characters starting within the search size belong to this data
+            const u64 owned = offset >= searchSize ? 0 : searchSize - offset >= BlockSize ? AllBits : (1ULL << (searchSize - offset)) - 1;
+
+            // UTF-16 characters starting at the last byte of the block end with the first byte of the next one
+            const u64 wideText = masks.printable | masks.latin1;
+            const u8 next = block[BlockSize];
+            const u64 nextIsZero = u64(next == 0x00) << 63;
+            const u64 nextIsText = u64((next >= 0x20 && next <= 0x7E) || next >= 0xA0) << 63;
+
+            u64 utf8Characters = 0;
+            if (utf8) {
+                u64 nextCarry = 0;
+                utf8Characters = (masks.printable & owned) | validateUtf8(block, masks.lead & owned, nextCarry) | utf8Carry;
+                utf8Carry = nextCarry;
+            }
+
+            for (auto &lane : lanes) {
+                u64 characters = 0;
+                switch (lane.encoding) {
+                    case StringEncoding::ASCII:
+                        characters = masks.printable & owned;
+                        break;
+                    case StringEncoding::UTF8:
+                        characters = utf8Characters;
+                        break;
+                    case StringEncoding::UTF16LE:
+                        characters = wideText & ((masks.zero >> 1) | nextIsZero) & owned;
+                        break;
+                    case StringEncoding::UTF16BE:
+                        characters = masks.zero & ((wideText >> 1) | nextIsText) & owned;
+                        break;
+                }
+
+                // Strings start and end wherever a character follows something else or the other way around
+                characters &= lane.bits;
+                u64 previous = lane.inString ? (1ULL << lane.firstBit) : 0;
+                u64 boundaries = (characters ^ ((characters << lane.stride) | previous)) & lane.bits;
+
+                while (boundaries != 0) {
+                    toggleString(lane, offset + std::countr_zero(boundaries));
+                    boundaries &= boundaries - 1;
+                }
+            }
+        }
+
+        for (auto &lane : lanes) {
+            if (lane.inString)
+                toggleString(lane, offset + lane.firstBit);
+        }
+
+        std::stable_sort(result.strings.begin(), result.strings.end(), [](const auto &left, const auto &right) {
+            return left.offset < right.offset;
+        });
+        std::stable_sort(result.edgeStrings.begin(), result.edgeStrings.end(), [](const auto &left, const auto &right) {
+            return left.string.offset < right.string.offset;
+        });
+    }
+
+    // Holes in sparse files only contain zeros, but the wide characters right before them end in there
+    StringExtractionJob::StringExtractionJob(prv::Provider *provider, const StringExtractionSettings &settings)
+        : ChunkedJob(provider, provider->isReadable() ? provider->getDataExtents(0x00, provider->getSize(), MaxCharacterSize - 1) : std::vector<Region>{ }, MaxCharacterSize - 1,
+                     [settings](std::span<const u8> data, const Chunk &chunk, ExtractedStrings &result) {
+                         extractStrings(data, chunk.searchSize, chunk.address, settings, result);
+                     }),
+          m_settings(settings) {
+
+    }
+
+    void StringExtractionJob::takeResults(std::vector<FoundString> &results) {
+        auto finishPendingStrings = [this] {
+            for (auto &string : this->m_pendingStrings) {
+                if (finishString(string, this->m_settings))
+                    this->m_heldStrings.push_back(string.string);
+            }
+
+            this->m_pendingStrings.clear();
+        };
+
+        // Strings are handed out in order of their offset, so the ones after a string that may still grow have to wait for it
+        auto releaseHeldStrings = [&, this] {
+            u64 firstPendingOffset = std::numeric_limits<u64>::max();
+            for (const auto &string : this->m_pendingStrings)
+                firstPendingOffset = std::min(firstPendingOffset, string.string.offset);
+
+            std::stable_sort(this->m_heldStrings.begin(), this->m_heldStrings.end(), [](const auto &left, const auto &right) { return left.offset < right.offset; });
+
+            auto released = std::find_if(this->m_heldStrings.begin(), this->m_heldStrings.end(), [&](const auto &string) { return string.offset >= firstPendingOffset; });
+            results.insert(results.end(), this->m_heldStrings.begin(), released);
+            this->m_heldStrings.erase(this->m_heldStrings.begin(), released);
+        };
+
+        bool allTaken = this->takeChunks([&, this](const Chunk &chunk, ExtractedStrings &chunkStrings) {
+            std::vector<PartialString> stillPending;
+
+            for (auto &string : chunkStrings.edgeStrings) {
+                // Strings at the start of the chunk continue pending ones of the same encoding that end right where they start
+                auto pendingString = std::find_if(this->m_pendingStrings.begin(), this->m_pendingStrings.end(), [&](const auto &pending) {
+                    return pending.string.encoding == string.string.encoding && pending.string.offset + pending.string.size == string.string.offset &&
+                           u64(pending.string.size) + string.string.size <= MaxStringSize;
+                });
+
+                if (pendingString != this->m_pendingStrings.end()) {
+                    pendingString->string.size += string.string.size;
+                    pendingString->length += string.length;
+
+                    string = *pendingString;
+                    this->m_pendingStrings.erase(pendingString);
+                }
+
+                if (string.string.offset + string.string.size >= chunk.address + chunk.searchSize)
+                    stillPending.push_back(string);
+                else if (finishString(string, this->m_settings))
+                    this->m_heldStrings.push_back(string.string);
+            }
+
+            finishPendingStrings();
+            this->m_pendingStrings = std::move(stillPending);
+
+            this->m_heldStrings.insert(this->m_heldStrings.end(), chunkStrings.strings.begin(), chunkStrings.strings.end());
+            releaseHeldStrings();
+        });
+
+        if (allTaken) {
+            finishPendingStrings();
+            releaseHeldStrings();
+        }
+    }
+
+
+    StringFilterJob::StringFilterJob(prv::Provider *provider, std::span<const FoundString> strings, u64 firstIndex, std::string filter)
+        : StringFilterJob(provider, sortStrings(strings, firstIndex), std::move(filter)) {
+
+    }
+
+    StringFilterJob::StringFilterJob(prv::Provider *provider, IndexedStrings strings, std::string filter)
+        : ChunkedJob(provider, groupStrings(*strings), [strings, filter = std::move(filter)](std::span<const u8> data, const Chunk &chunk, std::vector<u64> &result) {
+            auto string = std::lower_bound(strings->begin(), strings->end(), chunk.address, [](const IndexedString &string, u64 address) {
+                return string.string.offset < address;
+            });
+
+            for (; string != strings->end() && string->string.offset < chunk.address + chunk.searchSize; string++) {
+                const u64 position = string->string.offset - chunk.address;
+                if (position + string->string.size > data.size())
+                    continue;
+
+                // ASCII and UTF-8 text is the data itself, only UTF-16 strings have to be decoded
+                auto bytes = data.subspan(position, string->string.size);
+                bool matches;
+                if (string->string.encoding == StringEncoding::ASCII || string->string.encoding == StringEncoding::UTF8)
+                    matches = std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size()).find(filter) != std::string_view::npos;
+                else
+                    matches = decodeString(bytes, string->string.encoding).find(filter) != std::string::npos;
+
+                if (matches)
+                    result.push_back(string->index);
+            }
+
+            std::sort(result.begin(), result.end());
+        }) {
+
+    }
+
+    StringFilterJob::IndexedStrings StringFilterJob::sortStrings(std::span<const FoundString> strings, u64 firstIndex) {
+        auto sorted = std::make_shared<std::vector<IndexedString>>();
+        sorted->reserve(strings.size());
+
+        for (size_t i = 0; i < strings.size(); i++)
+            sorted->push_back({ strings[i], firstIndex + i });
+
+        // Extracted strings already come in order of their offset, the list only changes order when it gets sorted by another column
+        auto byOffset = [](const IndexedString &left, const IndexedString &right) { return left.string.offset < right.string.offset; };
+        if (!std::is_sorted(sorted->begin(), sorted->end(), byOffset))
+            std::stable_sort(sorted->begin(), sorted->end(), byOffset);
+
+        return sorted;
+    }
+
+    /* Chunks span the data of all strings starting within their search size, strings at the same offset end up in the same chunk */
+    std::vector<StringFilterJob::Chunk> StringFilterJob::groupStrings(const std::vector<IndexedString> &strings) {
+        std::vector<Chunk> chunks;
+
+        for (const auto &[string, index] : strings) {
+            const u64 end = string.offset + string.size;
+
+            if (!chunks.empty()) {
+                auto &chunk = chunks.back();
+
+                if (string.offset == chunk.address + chunk.searchSize - 1 || end - chunk.address <= ChunkSize) {
+                    chunk.searchSize = string.offset - chunk.address + 1;
+                    chunk.size = std::max<u64>(chunk.size, end - chunk.address);
+                    continue;
+                }
+            }
+
+            chunks.push_back({ string.offset, string.size, 1 });
+        }
+
+        return chunks;
+    }
+
+    void StringFilterJob::takeResults(std::vector<u64> &indices) {
+        this->takeChunks([&](const Chunk&, std::vector<u64> &chunkIndices) {
+            if (chunkIndices.empty())
+                return;
+
+            // Chunks are taken in order of their offset, which is the order of the list unless it was sorted by another column
+            size_t middle = indices.size();
+            indices.insert(indices.end(), chunkIndices.begin(), chunkIndices.end());
+
+            if (middle != 0 && indices[middle - 1] > indices[middle])
+                std::inplace_merge(indices.begin(), indices.begin() + middle, indices.end());
+        });
+    }
+
+}
\ No newline at end of file
@@ -1,5 +1,9 @@
 #include "lang/evaluator.hpp"
 
+#include "helpers/search.hpp"
+
+#include <algorithm>
+
 namespace hex::lang {
 
     #define BUILTIN_FUNCTION(name) ASTNodeIntegerLiteral* Evaluator::name(std::vector<ASTNodeIntegerLiteral*> params)
@@ -18,18 +22,43 @@ namespace hex::lang {
             }, params[i]->getValue()));
         }
 
-        std::vector<u8> bytes(sequence.size(), 0x00);
+        constexpr static size_t ChunkSize = 0x10'0000;
+
         u32 occurrences = 0;
-        for (u64 offset = 0; offset < this->m_provider->getSize() - sequence.size(); offset++) {
-            this->m_provider->read(offset, bytes.data(), bytes.size());
+        u64 dataSize = this->m_provider->getSize();
+
+        prv::ScopedAccessHint accessHint(this->m_provider, prv::AccessHint::Sequential);
+
+        // Holes in sparse files only contain zeros, only the data around them can contain a sequence with other bytes in it
+        std::vector<Region> extents = { { 0x00, dataSize } };
+        if (std::any_of(sequence.begin(), sequence.end(), [](u8 byte) { return byte != 0x00; }))
+            extents = this->m_provider->getDataExtents(0x00, dataSize, sequence.size() - 1);
+
+        SequenceMatcher matcher(sequence);
+
+        for (const auto &extent : extents) {
+            u64 extentEnd = extent.address + extent.size;
+
+            for (u64 chunkOffset = extent.address; chunkOffset + sequence.size() <= extentEnd; chunkOffset += ChunkSize) {
+                // Let chunks overlap by the length of the sequence so matches crossing a chunk border are found as well
+                auto chunk = this->m_provider->getView(chunkOffset, std::min(u64(ChunkSize + sequence.size() - 1), extentEnd - chunkOffset));
+
+                std::optional<u64> foundOffset;
+                matcher.find(chunk.getSpan(), [&](size_t offsetInChunk) {
+                    if (offsetInChunk >= ChunkSize)
+                        return false;
+
+                    if (LITERAL_COMPARE(occurrenceIndex, occurrenceIndex > occurrences)) {
+                        occurrences++;
+                        return true;
+                    }
 
-            if (bytes == sequence) {
-                if (LITERAL_COMPARE(occurrenceIndex, occurrenceIndex < occurrences)) {
-                    occurrences++;
-                    continue;
-                }
+                    foundOffset = chunkOffset + offsetInChunk;
+                    return false;
+                });
 
-                return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned64Bit, offset });
+                if (foundOffset.has_value())
+                    return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned64Bit, foundOffset.value() });
             }
         }
 
@@ -0,0 +1,399 @@
+#include "providers/compressed_file_provider.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include <sys/stat.h>
+
+namespace hex::prv {
+
+    namespace {
+
+        constexpr std::array<char, 8> IndexMagic = { 'I', 'M', 'H', 'E', 'X', 'I', 'D', 'X' };
+        constexpr u32 IndexVersion = 2;
+
+        struct IndexHeader {
+            std::array<char, 8> magic;
+            u32 version;
+            u32 checkpointSpan;
+            u64 compressedSize;
+            u64 modificationTime;
+            u64 uncompressedSize;
+            u64 checkpointCount;
+        };
+
+        /* Checkpoint fields get written one by one so the index file doesn't contain struct padding */
+        template<typename T>
+        bool writeField(FILE *file, const T &value) {
+            return fwrite(&value, sizeof(value), 1, file) == 1;
+        }
+
+        template<typename T>
+        bool readField(FILE *file, T &value) {
+            return fread(&value, sizeof(value), 1, file) == 1;
+        }
+
+    }
+
+    CompressedFileProvider::CompressedFileProvider(std::string_view path) : Provider(), m_path(path) {
+        this->m_inputBuffer.resize(InputBufferSize);
+
+        struct stat fileStats = { };
+        if (stat(this->m_path.c_str(), &fileStats) != 0)
+            return;
+
+        this->m_compressedSize = fileStats.st_size;
+        this->m_modificationTime = fileStats.st_mtime;
+
+        this->m_file = fopen(this->m_path.c_str(), "rb");
+        if (this->m_file == nullptr)
+            return;
+
+        std::array<u8, 2> magic = { 0 };
+        if (fread(magic.data(), 1, magic.size(), this->m_file) == magic.size())
+            this->m_isGzip = magic[0] == 0x1F && magic[1] == 0x8B;
+
+        if (inflateInit2(&this->m_stream, -15) != Z_OK)
+            return;
+
+        // Decompressed data gets cached in blocks, decompressing the data in front of a block is what makes a read expensive
+        this->enableBlockCache(0x1'0000, 64);
+
+        this->m_indexLoaded = this->loadIndex();
+        if (!this->m_indexLoaded) {
+            this->m_indexing = true;
+            this->m_indexThread = std::thread([this] {
+                if (this->buildIndex()) {
+                    this->m_indexLoaded = true;
+                    this->storeIndex();
+                }
+
+                this->m_indexing = false;
+            });
+        }
+    }
+
+    CompressedFileProvider::~CompressedFileProvider() {
+        this->m_cancelIndexing = true;
+        if (this->m_indexThread.joinable())
+            this->m_indexThread.join();
+
+        inflateEnd(&this->m_stream);
+
+        if (this->m_file != nullptr)
+            fclose(this->m_file);
+    }
+
+
+    bool CompressedFileProvider::buildIndex() {
+        this->m_checkpoints.clear();
+
+        z_stream stream = { };
+        if (inflateInit2(&stream, 47) != Z_OK)
+            return false;
+
+        SCOPE_EXIT( inflateEnd(&stream); );
+
+        std::vector<u8> input(InputBufferSize);
+        std::vector<u8> window(WindowSize);
+
+        u64 totalIn = 0, totalOut = 0, lastCheckpoint = 0;
+
+        fseeko64(this->m_file, 0, SEEK_SET);
+
+        int result = Z_OK;
+        stream.avail_out = 0;
+        do {
+            if (this->m_cancelIndexing)
+                return false;
+
+            stream.avail_in = fread(input.data(), 1, input.size(), this->m_file);
+            if (stream.avail_in == 0)
+                return false;
+
+            this->m_indexedSize += stream.avail_in;
+
+            stream.next_in = input.data();
+
+            do {
+                // The output goes into a circular buffer, only the last 32 KiB are needed as dictionary for a checkpoint
+                if (stream.avail_out == 0) {
+                    stream.avail_out = WindowSize;
+                    stream.next_out = window.data();
+                }
+
+                totalIn += stream.avail_in;
+                totalOut += stream.avail_out;
+                result = inflate(&stream, Z_BLOCK);
+                totalIn -= stream.avail_in;
+                totalOut -= stream.avail_out;
+
+                if (result == Z_NEED_DICT || result == Z_DATA_ERROR || result == Z_MEM_ERROR)
+                    return false;
+
+                if (result == Z_STREAM_END) {
+                    // Concatenated gzip members get decompressed as one continuous stream
+                    if (this->m_isGzip && (stream.avail_in != 0 || ungetc(getc(this->m_file), this->m_file) != EOF)) {
+                        if (inflateReset2(&stream, 31) != Z_OK)
+                            return false;
+
+                        result = Z_OK;
+                        continue;
+                    }
+
+                    break;
+                }
+
+                // Checkpoints can only be placed at the end of a deflate block that isn't the last one
+                bool atBlockBoundary = (stream.data_type & 128) && !(stream.data_type & 64);
+                if (atBlockBoundary && (totalOut == 0 || totalOut - lastCheckpoint > CheckpointSpan)) {
+                    Checkpoint checkpoint = { totalOut, totalIn, u8(stream.data_type & 7), std::vector<u8>(WindowSize, 0x00) };
+
+                    size_t left = stream.avail_out;
+                    if (left != 0)
+                        std::memcpy(checkpoint.window.data(), window.data() + WindowSize - left, left);
+                    if (left < WindowSize)
+                        std::memcpy(checkpoint.window.data() + left, window.data(), WindowSize - left);
+
+                    this->m_checkpoints.push_back(std::move(checkpoint));
+                    lastCheckpoint = totalOut;
+                }
+            } while (stream.avail_in != 0);
+        } while (result != Z_STREAM_END);
+
+        this->m_uncompressedSize = totalOut;
+
+        return !this->m_checkpoints.empty();
+    }
+
+    bool CompressedFileProvider::loadIndex() {
+        FILE *indexFile = fopen((this->m_path + IndexFileExtension).c_str(), "rb");
+        if (indexFile == nullptr)
+            return false;
+
+        SCOPE_EXIT( fclose(indexFile); );
+
+        // Indices that were built for a different version of the file or with different settings get rebuilt
+        IndexHeader header = { };
+        if (fread(&header, sizeof(header), 1, indexFile) != 1)
+            return false;
+
+        if (header.magic != IndexMagic || header.version != IndexVersion || header.checkpointSpan != CheckpointSpan)
+            return false;
+        if (header.compressedSize != this->m_compressedSize || header.modificationTime != this->m_modificationTime)
+            return false;
+
+        std::vector<Checkpoint> checkpoints;
+        for (u64 i = 0; i < header.checkpointCount; i++) {
+            Checkpoint checkpoint = { 0, 0, 0, std::vector<u8>(WindowSize) };
+
+            if (!readField(indexFile, checkpoint.uncompressedOffset) || !readField(indexFile, checkpoint.compressedOffset) || !readField(indexFile, checkpoint.bits))
+                return false;
+            if (fread(checkpoint.window.data(), 1, WindowSize, indexFile) != WindowSize)
+                return false;
+
+            checkpoints.push_back(std::move(checkpoint));
+        }
+
+        if (checkpoints.empty())
+            return false;
+
+        this->m_checkpoints = std::move(checkpoints);
+        this->m_uncompressedSize = header.uncompressedSize;
+
+        return true;
+    }
+
+    void CompressedFileProvider::storeIndex() {
+        // The index is only a cache, not being able to write it next to the file just means it has to be built again next time
+        std::string indexPath = this->m_path + IndexFileExtension;
+        FILE *indexFile = fopen(indexPath.c_str(), "wb");
+        if (indexFile == nullptr)
+            return;
+
+        IndexHeader header = { IndexMagic, IndexVersion, CheckpointSpan, this->m_compressedSize, this->m_modificationTime, this->m_uncompressedSize, this->m_checkpoints.size() };
+        bool success = fwrite(&header, sizeof(header), 1, indexFile) == 1;
+
+        for (const auto &checkpoint : this->m_checkpoints) {
+            if (!success)
+                break;
+
+            success = writeField(indexFile, checkpoint.uncompressedOffset) && writeField(indexFile, checkpoint.compressedOffset) && writeField(indexFile, checkpoint.bits)
+                      && fwrite(checkpoint.window.data(), 1, WindowSize, indexFile) == WindowSize;
+        }
+
+        fclose(indexFile);
+
+        if (!success)
+            std::remove(indexPath.c_str());
+    }
+
+
+    bool CompressedFileProvider::restartStream(const Checkpoint &checkpoint) {
+        this->m_streamValid = false;
+
+        // Checkpoints may lie in the middle of a byte, the remaining bits of that byte have to be fed to the decompressor first
+        if (fseeko64(this->m_file, checkpoint.compressedOffset - (checkpoint.bits != 0 ? 1 : 0), SEEK_SET) != 0)
+            return false;
+
+        if (inflateReset2(&this->m_stream, -15) != Z_OK)
+            return false;
+
+        this->m_stream.avail_in = 0;
+
+        if (checkpoint.bits != 0) {
+            int byte = getc(this->m_file);
+            if (byte == EOF || inflatePrime(&this->m_stream, checkpoint.bits, byte >> (8 - checkpoint.bits)) != Z_OK)
+                return false;
+        }
+
+        if (inflateSetDictionary(&this->m_stream, checkpoint.window.data(), WindowSize) != Z_OK)
+            return false;
+
+        this->m_streamRaw = true;
+        this->m_streamOffset = checkpoint.uncompressedOffset;
+        this->m_streamValid = true;
+
+        return true;
+    }
+
+    bool CompressedFileProvider::seekStream(u64 offset) {
+        // Reads slightly ahead of the last one continue with the current stream, everything else restarts at the closest checkpoint
+        if (!this->m_streamValid || offset < this->m_streamOffset || offset - this->m_streamOffset > CheckpointSpan) {
+            auto checkpoint = std::upper_bound(this->m_checkpoints.begin(), this->m_checkpoints.end(), offset, [](u64 offset, const Checkpoint &checkpoint) {
+                return offset < checkpoint.uncompressedOffset;
+            });
+
+            if (checkpoint == this->m_checkpoints.begin())
+                return false;
+
+            if (!this->restartStream(*std::prev(checkpoint)))
+                return false;
+        }
+
+        std::array<u8, 0x4000> discard;
+        while (this->m_streamOffset < offset) {
+            if (this->inflateStream(discard.data(), std::min<u64>(discard.size(), offset - this->m_streamOffset)) == 0)
+                return false;
+        }
+
+        return true;
+    }
+
+    bool CompressedFileProvider::skipInput(size_t size) {
+        while (size > 0) {
+            if (this->m_stream.avail_in == 0) {
+                this->m_stream.avail_in = fread(this->m_inputBuffer.data(), 1, this->m_inputBuffer.size(), this->m_file);
+                this->m_stream.next_in = this->m_inputBuffer.data();
+
+                if (this->m_stream.avail_in == 0)
+                    return false;
+            }
+
+            size_t skipSize = std::min<size_t>(size, this->m_stream.avail_in);
+            this->m_stream.next_in += skipSize;
+            this->m_stream.avail_in -= skipSize;
+            size -= skipSize;
+        }
+
+        return true;
+    }
+
+    size_t CompressedFileProvider::inflateStream(u8 *buffer, size_t size) {
+        if (!this->m_streamValid)
+            return 0;
+
+        this->m_stream.next_out = buffer;
+        this->m_stream.avail_out = size;
+
+        while (this->m_stream.avail_out > 0) {
+            if (this->m_stream.avail_in == 0) {
+                this->m_stream.avail_in = fread(this->m_inputBuffer.data(), 1, this->m_inputBuffer.size(), this->m_file);
+                this->m_stream.next_in = this->m_inputBuffer.data();
+
+                if (this->m_stream.avail_in == 0)
+                    break;
+            }
+
+            int result = inflate(&this->m_stream, Z_NO_FLUSH);
+
+            if (result == Z_STREAM_END) {
+                // A stream restarted at a checkpoint is raw deflate data, the gzip trailer of its member needs to be skipped by hand
+                if (!this->m_isGzip || (this->m_streamRaw && !this->skipInput(8)) || inflateReset2(&this->m_stream, 31) != Z_OK) {
+                    this->m_streamValid = false;
+                    break;
+                }
+
+                this->m_streamRaw = false;
+            } else if (result != Z_OK) {
+                this->m_streamValid = false;
+                break;
+            }
+        }
+
+        size_t producedSize = size - this->m_stream.avail_out;
+        this->m_streamOffset += producedSize;
+
+        return producedSize;
+    }
+
+
+    bool CompressedFileProvider::isAvailable() {
+        return this->m_file != nullptr && this->m_indexLoaded;
+    }
+
+    bool CompressedFileProvider::isReadable() {
+        return isAvailable();
+    }
+
+    bool CompressedFileProvider::isWritable() {
+        return false;
+    }
+
+
+    void CompressedFileProvider::readRaw(u64 offset, void *buffer, size_t size) {
+        if (!this->isAvailable() || buffer == nullptr || size == 0 || offset >= this->getActualSize())
+            return;
+
+        size = std::min<u64>(size, this->getActualSize() - offset);
+
+        size_t readSize = 0;
+        if (this->seekStream(offset))
+            readSize = this->inflateStream(reinterpret_cast<u8*>(buffer), size);
+
+        // Corrupted data reads as zeros
+        if (readSize < size)
+            std::memset(reinterpret_cast<u8*>(buffer) + readSize, 0x00, size - readSize);
+    }
+
+    void CompressedFileProvider::writeRaw(u64, const void*, size_t) {
+        // Compressed files are only ever read, isWritable() keeps the editor from writing and applied patches get dropped
+    }
+
+    u64 CompressedFileProvider::getActualSize() {
+        return this->m_indexLoaded ? this->m_uncompressedSize : 0;
+    }
+
+    float CompressedFileProvider::getIndexingProgress() const {
+        if (this->m_compressedSize == 0)
+            return 0.0F;
+
+        return float(this->m_indexedSize) / float(this->m_compressedSize);
+    }
+
+    std::vector<std::pair<std::string, std::string>> CompressedFileProvider::getDataInformation() {
+        std::vector<std::pair<std::string, std::string>> result;
+
+        result.emplace_back("File path", this->m_path);
+        result.emplace_back("Format", this->m_isGzip ? "gzip" : "zlib");
+        result.emplace_back("Compressed size", hex::toByteString(this->m_compressedSize));
+        if (this->m_indexLoaded) {
+            result.emplace_back("Uncompressed size", hex::toByteString(this->m_uncompressedSize));
+            result.emplace_back("Checkpoints", std::to_string(this->m_checkpoints.size()));
+        }
+
+        return result;
+    }
+
+}
\ No newline at end of file
@@ -1,10 +1,16 @@
 #include "providers/file_provider.hpp"
 
 #include <time.h>
+#include <errno.h>
+#include <algorithm>
+#include <array>
 #include <cstring>
+#include <filesystem>
 
 #include "helpers/project_file_handler.hpp"
 
+#include <zlib.h>
+
 #if defined(OS_WINDOWS)
 #include <locale>
 #include <codecvt>
@@ -12,6 +18,106 @@
 
 namespace hex::prv {
 
+    #if defined(OS_WINDOWS)
+    using FileHandle = HANDLE;
+
+    static std::wstring toWidePath(std::string_view path) {
+        int len;
+        int slength = (int)path.length() + 1;
+        len = MultiByteToWideChar(CP_UTF8, 0, path.data(), slength, 0, 0);
+        wchar_t* buf = new wchar_t[len];
+        MultiByteToWideChar(CP_UTF8, 0, path.data(), slength, buf, len);
+        std::wstring widePath = buf;
+        delete[] buf;
+
+        return widePath;
+    }
+    #else
+    using FileHandle = int;
+    #endif
+
+    static bool readFromFile(FileHandle file, u64 offset, void *buffer, size_t size) {
+        auto output = reinterpret_cast<u8*>(buffer);
+        while (size > 0) {
+            #if defined(OS_WINDOWS)
+            OVERLAPPED overlapped = { };
+            overlapped.Offset     = DWORD(offset & 0xFFFF'FFFF);
+            overlapped.OffsetHigh = DWORD(offset >> 32);
+
+            DWORD bytesRead = 0;
+            if (!ReadFile(file, output, DWORD(std::min<size_t>(size, 0x4000'0000)), &bytesRead, &overlapped) || bytesRead == 0)
+                return false;
+            #else
+            ssize_t bytesRead = pread(file, output, size, offset);
+            if (bytesRead <= 0)
+                return false;
+            #endif
+
+            output += bytesRead;
+            offset += bytesRead;
+            size   -= bytesRead;
+        }
+
+        return true;
+    }
+
+    static bool writeToFile(FileHandle file, u64 offset, const void *buffer, size_t size) {
+        auto input = reinterpret_cast<const u8*>(buffer);
+        while (size > 0) {
+            #if defined(OS_WINDOWS)
+            OVERLAPPED overlapped = { };
+            overlapped.Offset     = DWORD(offset & 0xFFFF'FFFF);
+            overlapped.OffsetHigh = DWORD(offset >> 32);
+
+            DWORD bytesWritten = 0;
+            if (!WriteFile(file, input, DWORD(std::min<size_t>(size, 0x4000'0000)), &bytesWritten, &overlapped) || bytesWritten == 0)
+                return false;
+            #else
+            ssize_t bytesWritten = pwrite(file, input, size, offset);
+            if (bytesWritten <= 0)
+                return false;
+            #endif
+
+            input  += bytesWritten;
+            offset += bytesWritten;
+            size   -= bytesWritten;
+        }
+
+        return true;
+    }
+
+    static bool copyFileContents(FileHandle source, FileHandle destination, u64 size) {
+        u64 offset = 0;
+
+        #if defined(OS_LINUX)
+        // Reflinking shares the data blocks of the source file and finishes instantly on file systems that support it
+        if (ioctl(destination, FICLONE, source) == 0)
+            return true;
+
+        // Otherwise let the kernel copy the data without passing it through user space
+        loff_t inputOffset = 0, outputOffset = 0;
+        while (offset < size) {
+            ssize_t copied = copy_file_range(source, &inputOffset, destination, &outputOffset, size - offset, 0);
+            if (copied <= 0)
+                break;
+
+            offset += copied;
+        }
+        #endif
+
+        std::vector<u8> buffer(std::min<u64>(Provider::MaxPatchWriteSize, size - offset));
+        while (offset < size) {
+            size_t bufferSize = std::min<u64>(buffer.size(), size - offset);
+
+            if (!readFromFile(source, offset, buffer.data(), bufferSize) || !writeToFile(destination, offset, buffer.data(), bufferSize))
+                return false;
+
+            offset += bufferSize;
+        }
+
+        return true;
+    }
+
     FileProvider::FileProvider(std::string_view path) : Provider(), m_path(path) {
         this->m_fileStatsValid = stat(path.data(), &this->m_fileStats) == 0;
 
@@ -19,16 +125,7 @@ namespace hex::prv {
         this->m_writable = true;
 
         #if defined(OS_WINDOWS)
-        std::wstring widePath;
-        {
-            int len;
-            int slength = (int)path.length() + 1;
-            len = MultiByteToWideChar(CP_UTF8, 0, path.data(), slength, 0, 0);
-            wchar_t* buf = new wchar_t[len];
-            MultiByteToWideChar(CP_UTF8, 0, path.data(), slength, buf, len);
-            widePath = buf;
-            delete[] buf;
-        }
+        std::wstring widePath = toWidePath(path);
 
         LARGE_INTEGER fileSize = { 0 };
         this->m_file = reinterpret_cast<HANDLE>(CreateFileW(widePath.data(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
@@ -45,32 +142,19 @@ namespace hex::prv {
 
         ScopeExit fileCleanup([this]{
             this->m_readable = false;
-            this->m_file = nullptr;
             CloseHandle(this->m_file);
+            this->m_file = nullptr;
         });
         if (this->m_file == nullptr || this->m_file == INVALID_HANDLE_VALUE) {
             return;
         }
 
-        this->m_mapping = CreateFileMapping(this->m_file, nullptr, PAGE_READWRITE, fileSize.HighPart, fileSize.LowPart, nullptr);
+        this->m_mapping = CreateFileMapping(this->m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
         if (this->m_mapping == nullptr || this->m_mapping == INVALID_HANDLE_VALUE) {
             return;
         }
 
-        ScopeExit mappingCleanup([this]{
-            this->m_readable = false;
-            this->m_mapping = nullptr;
-            CloseHandle(this->m_mapping);
-        });
-
-        this->m_mappedFile = MapViewOfFile(this->m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, this->m_fileSize);
-        if (this->m_mappedFile == nullptr) {
-            this->m_readable = false;
-            return;
-        }
-
         fileCleanup.release();
-        mappingCleanup.release();
 
         ProjectFile::setFilePath(path);
 
@@ -88,31 +172,164 @@ namespace hex::prv {
 
             this->m_fileSize = this->m_fileStats.st_size;
 
-            this->m_mappedFile = mmap(nullptr, this->m_fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, this->m_file, 0);
+            #if defined(OS_LINUX)
+            this->m_fileWatch = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (this->m_fileWatch != -1 && inotify_add_watch(this->m_fileWatch, path.data(), IN_MODIFY | IN_CLOSE_WRITE) == -1) {
+                close(this->m_fileWatch);
+                this->m_fileWatch = -1;
+            }
+
+            if (this->m_fileWatch != -1 && this->m_fileSize <= MaxChecksummedFileSize)
+                this->m_blockChecksums.resize((this->m_fileSize + ChangeBlockSize - 1) / ChangeBlockSize);
+            #endif
 
         #endif
+
+        // Browsing in the hex editor jumps around, scans switch to sequential access while they run
+        this->setAccessHint(AccessHint::Random);
     }
 
     FileProvider::~FileProvider() {
+        this->m_mappedWindow.reset();
+
         #if defined(OS_WINDOWS)
-        if (this->m_mappedFile != nullptr)
-            UnmapViewOfFile(this->m_mappedFile);
         if (this->m_mapping != nullptr)
             CloseHandle(this->m_mapping);
         if (this->m_file != nullptr)
             CloseHandle(this->m_file);
         #else
-        munmap(this->m_mappedFile, this->m_fileSize);
-        close(this->m_file);
+        if (this->m_file != -1)
+            close(this->m_file);
+        #endif
+
+        #if defined(OS_LINUX)
+        if (this->m_fileWatch != -1)
+            close(this->m_fileWatch);
+        #endif
+    }
+
+    FileProvider::MappedWindow::~MappedWindow() {
+        #if defined(OS_WINDOWS)
+        UnmapViewOfFile(this->data);
+        #else
+        munmap(this->data, this->size);
+        #endif
+    }
+
+    std::shared_ptr<FileProvider::MappedWindow> FileProvider::getMappedWindow(u64 offset, size_t size) {
+        std::scoped_lock lock(this->m_windowMutex);
+
+        // Touching mapped pages past the end of a file that another process truncated raises SIGBUS. Changes only get noticed
+        // when they're polled for, so the size is checked again before the mapping is used and windows past the end get dropped.
+        // Requests past the end get served without the mapping then, which just reads fewer bytes
+        u64 mappableSize = this->m_fileSize;
+        #if !defined(OS_WINDOWS)
+        struct stat fileStats = { };
+        if (fstat(this->m_file, &fileStats) != 0)
+            return nullptr;
+
+        mappableSize = std::min<u64>(mappableSize, fileStats.st_size);
+        #endif
+
+        auto &window = this->m_mappedWindow;
+        if (window != nullptr && window->offset + window->size > mappableSize)
+            window.reset();
+
+        if (window != nullptr && offset >= window->offset && (offset + size) <= (window->offset + window->size))
+            return window;
+
+        bool sequential = this->m_accessHint == AccessHint::Sequential;
+
+        u64 windowOffset = offset - (offset % MappingWindowAlignment);
+        if (windowOffset >= mappableSize)
+            return nullptr;
+
+        size_t windowSize = std::min<u64>(sequential ? SequentialWindowSize : MappingWindowSize, mappableSize - windowOffset);
+
+        // Requests that don't fit into a single window get served without the mapping
+        if ((offset + size) > (windowOffset + windowSize))
+            return nullptr;
+
+        #if defined(OS_WINDOWS)
+        void *data = MapViewOfFile(this->m_mapping, FILE_MAP_READ, DWORD(windowOffset >> 32), DWORD(windowOffset & 0xFFFF'FFFF), windowSize);
+        if (data == nullptr)
+            return nullptr;
+        #else
+        void *data = mmap(nullptr, windowSize, PROT_READ, MAP_SHARED, this->m_file, windowOffset);
+        if (data == MAP_FAILED)
+            return nullptr;
+        #endif
+
+        // Dropping the old window unmaps it, so only the pages of the current window count towards the resident set
+        window = std::shared_ptr<MappedWindow>(new MappedWindow { windowOffset, windowSize, data });
+        this->adviseWindow(*window);
+
+        // Start reading in the following window while the current one gets processed
+        if (sequential && windowOffset + windowSize < this->m_fileSize) {
+            #if defined(OS_LINUX)
+            posix_fadvise(this->m_file, windowOffset + windowSize, std::min<u64>(windowSize, this->m_fileSize - (windowOffset + windowSize)), POSIX_FADV_WILLNEED);
+            #endif
+        }
+
+        return window;
+    }
+
+    void FileProvider::adviseWindow(const MappedWindow &window) {
+        #if !defined(OS_WINDOWS)
+        int advice = MADV_NORMAL;
+        switch (this->m_accessHint) {
+            case AccessHint::Sequential: advice = MADV_SEQUENTIAL;  break;
+            case AccessHint::Random:     advice = MADV_RANDOM;      break;
+            default: break;
+        }
+
+        madvise(window.data, window.size, advice);
+        #endif
+    }
+
+    void FileProvider::applyAccessHint(AccessHint hint) {
+        std::scoped_lock lock(this->m_windowMutex);
+
+        Provider::applyAccessHint(hint);
+
+        #if !defined(OS_WINDOWS)
+        if (this->m_file == -1)
+            return;
+
+        #if defined(OS_LINUX)
+        int advice = POSIX_FADV_NORMAL;
+        switch (hint) {
+            case AccessHint::Sequential: advice = POSIX_FADV_SEQUENTIAL;    break;
+            case AccessHint::Random:     advice = POSIX_FADV_RANDOM;        break;
+            default: break;
+        }
+
+        // Covers the reads that bypass the mapping as well
+        posix_fadvise(this->m_file, 0, 0, advice);
+        #endif
+
+        if (this->m_mappedWindow != nullptr)
+            this->adviseWindow(*this->m_mappedWindow);
+        #endif
+    }
+
+    void FileProvider::prefetch(u64 offset, size_t size) {
+        if (offset >= this->m_fileSize || size == 0)
+            return;
+
+        size = std::min<u64>(size, this->m_fileSize - offset);
+
+        #if defined(OS_LINUX)
+        posix_fadvise(this->m_file, offset, size, POSIX_FADV_WILLNEED);
         #endif
     }
 
 
     bool FileProvider::isAvailable() {
         #if defined(OS_WINDOWS)
-        return this->m_file != nullptr && this->m_mapping != nullptr && this->m_mappedFile != nullptr;
+        return this->m_file != nullptr && this->m_mapping != nullptr;
         #else
-        return this->m_file != -1 && this->m_mappedFile != nullptr;
+        return this->m_file != -1;
         #endif
     }
 
@@ -129,40 +346,268 @@ namespace hex::prv {
         if ((offset + size) > this->getSize() || buffer == nullptr || size == 0)
             return;
 
-        std::memcpy(buffer, reinterpret_cast<u8*>(this->m_mappedFile) + offset, size);
+        this->readRaw(offset, buffer, size);
 
-        for (u64 i = 0; i < size; i++)
-            if (this->m_patches.back().contains(offset + i))
-                reinterpret_cast<u8*>(buffer)[i] = this->m_patches.back()[offset + i];
+        this->m_patches.overlay(offset, buffer, size);
     }
 
     void FileProvider::write(u64 offset, const void *buffer, size_t size) {
         if (buffer == nullptr || size == 0)
             return;
 
-        this->m_patches.push_back(this->m_patches.back());
+        this->addPatch(offset, buffer, size);
+    }
+
+    DataView FileProvider::getView(u64 offset, size_t size) {
+        if (offset >= this->getSize() || size == 0)
+            return { };
+
+        size = std::min<u64>(size, this->getSize() - offset);
 
-        for (u64 i = 0; i < size; i++)
-            this->m_patches.back()[offset + i] = reinterpret_cast<const u8*>(buffer)[i];
+        // Hand out the mapping directly unless some of the bytes in the range are patched
+        if (this->m_patches.overlaps(offset, size))
+            return Provider::getView(offset, size);
+
+        auto window = this->getMappedWindow(offset, size);
+        if (window == nullptr)
+            return Provider::getView(offset, size);
+
+        auto data = reinterpret_cast<const u8*>(window->data) + (offset - window->offset);
+        return DataView(std::span(data, size), window);
     }
 
     void FileProvider::readRaw(u64 offset, void *buffer, size_t size) {
-        if ((offset + size) > this->getSize() || buffer == nullptr || size == 0)
+        if ((offset + size) > this->getActualSize() || buffer == nullptr || size == 0)
             return;
 
-        std::memcpy(buffer, reinterpret_cast<u8*>(this->m_mappedFile) + offset, size);
+        if (auto window = this->getMappedWindow(offset, size); window != nullptr) {
+            std::memcpy(buffer, reinterpret_cast<u8*>(window->data) + (offset - window->offset), size);
+            return;
+        }
+
+        readFromFile(this->m_file, offset, buffer, size);
     }
 
     void FileProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
         if (buffer == nullptr || size == 0)
             return;
 
-        std::memcpy(reinterpret_cast<u8*>(this->m_mappedFile) + offset, buffer, size);
+        // The mapping is shared and read-only, writing through the file keeps all mapped windows in sync
+        writeToFile(this->m_file, offset, buffer, size);
+    }
+
+    bool FileProvider::saveAs(const std::string &path) {
+        // Saving over the opened file only requires the patches to be written back
+        std::error_code error;
+        if (std::filesystem::equivalent(path, this->m_path, error)) {
+            this->applyPatches();
+            return true;
+        }
+
+        #if defined(OS_WINDOWS)
+        HANDLE destination = CreateFileW(toWidePath(path).c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (destination == INVALID_HANDLE_VALUE)
+            return false;
+
+        SCOPE_EXIT( CloseHandle(destination); );
+        #else
+        int destination = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (destination == -1)
+            return false;
+
+        SCOPE_EXIT( close(destination); );
+        #endif
+
+        if (!copyFileContents(this->m_file, destination, this->getActualSize()))
+            return false;
+
+        // Only the patched extents differ from the copied file
+        for (const auto &[address, patch] : this->m_patches) {
+            if (!writeToFile(destination, address, patch.data(), patch.size()))
+                return false;
+        }
+
+        return true;
     }
-    size_t FileProvider::getActualSize() {
+
+    u64 FileProvider::getActualSize() {
         return this->m_fileSize;
     }
 
+    std::vector<Region> FileProvider::getDataExtentsRaw(u64 offset, size_t size) {
+        if (offset >= this->m_fileSize || size == 0)
+            return { };
+
+        size = std::min<u64>(size, this->m_fileSize - offset);
+        u64 end = offset + size;
+
+        std::vector<Region> result;
+
+        #if defined(OS_WINDOWS)
+        FILE_ALLOCATED_RANGE_BUFFER query = { };
+        query.FileOffset.QuadPart = offset;
+        query.Length.QuadPart = size;
+
+        std::array<FILE_ALLOCATED_RANGE_BUFFER, 64> ranges;
+        while (true) {
+            DWORD bytesReturned = 0;
+            bool moreData = false;
+            if (!DeviceIoControl(this->m_file, FSCTL_QUERY_ALLOCATED_RANGES, &query, sizeof(query), ranges.data(), ranges.size() * sizeof(ranges[0]), &bytesReturned, nullptr)) {
+                if (GetLastError() != ERROR_MORE_DATA)
+                    return { { offset, size } };
+
+                moreData = true;
+            }
+
+            u32 rangeCount = bytesReturned / sizeof(ranges[0]);
+            for (u32 i = 0; i < rangeCount; i++) {
+                u64 rangeStart = std::max<u64>(offset, ranges[i].FileOffset.QuadPart);
+                u64 rangeEnd   = std::min<u64>(end, ranges[i].FileOffset.QuadPart + ranges[i].Length.QuadPart);
+
+                if (rangeStart < rangeEnd)
+                    result.push_back({ rangeStart, rangeEnd - rangeStart });
+            }
+
+            if (!moreData || rangeCount == 0)
+                break;
+
+            u64 nextOffset = ranges[rangeCount - 1].FileOffset.QuadPart + ranges[rangeCount - 1].Length.QuadPart;
+            query.FileOffset.QuadPart = nextOffset;
+            query.Length.QuadPart = end - std::min(end, nextOffset);
+        }
+        #elif defined(SEEK_DATA) && defined(SEEK_HOLE)
+        u64 position = offset;
+        while (position < end) {
+            off_t dataStart = lseek(this->m_file, position, SEEK_DATA);
+            if (dataStart == -1) {
+                // ENXIO means there's no more data behind the position, anything else means holes aren't supported
+                if (errno == ENXIO)
+                    break;
+
+                return { { offset, size } };
+            }
+
+            if (u64(dataStart) >= end)
+                break;
+
+            off_t holeStart = lseek(this->m_file, dataStart, SEEK_HOLE);
+            u64 dataEnd = holeStart == -1 ? end : std::min<u64>(end, holeStart);
+
+            result.push_back({ u64(dataStart), dataEnd - dataStart });
+            position = dataEnd;
+        }
+        #else
+        result.push_back({ offset, size });
+        #endif
+
+        return result;
+    }
+
+    u64 FileProvider::getBlockChecksum(u64 blockIndex) {
+        u64 offset = blockIndex * ChangeBlockSize;
+        size_t size = std::min<u64>(ChangeBlockSize, this->m_fileSize - offset);
+
+        const u8 *data = nullptr;
+        std::vector<u8> buffer;
+
+        auto window = this->getMappedWindow(offset, size);
+        if (window != nullptr) {
+            data = reinterpret_cast<const u8*>(window->data) + (offset - window->offset);
+        } else {
+            buffer.resize(size);
+            readFromFile(this->m_file, offset, buffer.data(), size);
+            data = buffer.data();
+        }
+
+        return (u64(::crc32(0, data, size)) << 32) | ::adler32(1, data, size);
+    }
+
+    std::vector<Region> FileProvider::checkForChanges() {
+        #if defined(OS_LINUX)
+        if (this->m_fileWatch == -1)
+            return { };
+
+        bool fileModified = false;
+        {
+            alignas(inotify_event) std::array<char, 0x1000> events;
+            while (::read(this->m_fileWatch, events.data(), events.size()) > 0)
+                fileModified = true;
+        }
+
+        std::vector<Region> changes;
+
+        if (fileModified) {
+            struct stat fileStats = { };
+            if (fstat(this->m_file, &fileStats) != 0)
+                return { };
+
+            u64 oldSize = this->m_fileSize;
+            u64 newSize = fileStats.st_size;
+
+            if (oldSize != newSize) {
+                // The mapping only needs to be recreated if the size changed, the shared mapping already reflects all other changes
+                {
+                    std::scoped_lock lock(this->m_windowMutex);
+                    this->m_mappedWindow.reset();
+                    this->m_fileSize = newSize;
+                }
+
+                changes.push_back({ std::min(oldSize, newSize), std::max(oldSize, newSize) - std::min(oldSize, newSize) });
+            }
+
+            this->m_fileStats = fileStats;
+
+            if (newSize > MaxChecksummedFileSize) {
+                // Too big to keep checksums of, treat the whole file as changed
+                this->m_blockChecksums.clear();
+                this->m_checksumsValid = false;
+
+                return { { 0, newSize } };
+            } else if (!this->m_checksumsValid) {
+                // The file changed before all checksums were calculated so there's nothing to compare against
+                changes = { { 0, std::max(oldSize, newSize) } };
+            }
+
+            this->m_blockChecksums.resize((newSize + ChangeBlockSize - 1) / ChangeBlockSize);
+            this->m_checksumPosition = 0;
+        }
+
+        // Calculate the next few checksums. Once all of them are known, comparing them against the new ones shows what changed
+        u64 endPosition = std::min<u64>(this->m_blockChecksums.size(), this->m_checksumPosition + ChangeScanStepSize / ChangeBlockSize);
+        for (; this->m_checksumPosition < endPosition; this->m_checksumPosition++) {
+            u64 checksum = this->getBlockChecksum(this->m_checksumPosition);
+
+            if (this->m_checksumsValid && checksum != this->m_blockChecksums[this->m_checksumPosition]) {
+                u64 blockAddress = this->m_checksumPosition * ChangeBlockSize;
+                u64 blockSize = std::min<u64>(ChangeBlockSize, this->m_fileSize - blockAddress);
+
+                if (!changes.empty() && changes.back().address + changes.back().size == blockAddress)
+                    changes.back().size += blockSize;
+                else
+                    changes.push_back({ blockAddress, blockSize });
+            }
+
+            this->m_blockChecksums[this->m_checksumPosition] = checksum;
+        }
+
+        if (this->m_checksumPosition == this->m_blockChecksums.size())
+            this->m_checksumsValid = true;
+
+        if (changes.size() > MaxReportedChanges) {
+            u64 start = changes.front().address;
+            u64 end = 0;
+            for (const auto &change : changes)
+                end = std::max(end, change.address + change.size);
+
+            changes = { { start, end - start } };
+        }
+
+        return changes;
+        #else
+        return { };
+        #endif
+    }
+
     std::vector<std::pair<std::string, std::string>> FileProvider::getDataInformation() {
         std::vector<std::pair<std::string, std::string>> result;
 
@@ -0,0 +1,107 @@
+#include "providers/memory_provider.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace hex::prv {
+
+    MemoryProvider::MemoryProvider(std::vector<u8> &&data, std::string name)
+        : Provider(), m_name(std::move(name)), m_data(std::make_shared<std::vector<u8>>(std::move(data))) {
+
+    }
+
+
+    bool MemoryProvider::isAvailable() {
+        return true;
+    }
+
+    bool MemoryProvider::isReadable() {
+        return true;
+    }
+
+    bool MemoryProvider::isWritable() {
+        return true;
+    }
+
+
+    void MemoryProvider::read(u64 offset, void *buffer, size_t size) {
+        if ((offset + size) > this->getSize() || buffer == nullptr || size == 0)
+            return;
+
+        this->readRaw(offset, buffer, size);
+
+        this->m_patches.overlay(offset, buffer, size);
+    }
+
+    void MemoryProvider::write(u64 offset, const void *buffer, size_t size) {
+        if (buffer == nullptr || size == 0)
+            return;
+
+        if (offset + size > this->getActualSize())
+            this->resize(offset + size);
+
+        this->addPatch(offset, buffer, size);
+    }
+
+    DataView MemoryProvider::getView(u64 offset, size_t size) {
+        if (offset >= this->getSize() || size == 0)
+            return { };
+
+        size = std::min<u64>(size, this->getSize() - offset);
+
+        if (this->m_patches.overlaps(offset, size))
+            return Provider::getView(offset, size);
+
+        return DataView(std::span<const u8>(this->m_data->data() + offset, size), this->m_data);
+    }
+
+    void MemoryProvider::readRaw(u64 offset, void *buffer, size_t size) {
+        if ((offset + size) > this->getActualSize() || buffer == nullptr || size == 0)
+            return;
+
+        std::memcpy(buffer, this->m_data->data() + offset, size);
+    }
+
+    void MemoryProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
+        if (buffer == nullptr || size == 0)
+            return;
+
+        if (offset + size > this->getActualSize())
+            this->resize(offset + size);
+
+        // Views handed out before may still be read by other threads, they keep seeing the old buffer
+        if (this->m_data.use_count() > 1)
+            this->m_data = std::make_shared<std::vector<u8>>(*this->m_data);
+
+        std::memcpy(this->m_data->data() + offset, buffer, size);
+    }
+
+    u64 MemoryProvider::getActualSize() {
+        return this->m_data->size();
+    }
+
+    void MemoryProvider::resize(u64 size) {
+        auto &data = *this->m_data;
+
+        // Handed out views may still point into the old buffer so it has to stay untouched instead of being reallocated in place
+        if (size > data.capacity() || this->m_data.use_count() > 1) {
+            auto newData = std::make_shared<std::vector<u8>>();
+            newData->reserve(std::max<u64>(size, data.capacity() * 2));
+            newData->assign(data.begin(), data.end());
+            newData->resize(size, 0x00);
+
+            this->m_data = std::move(newData);
+        } else
+            data.resize(size, 0x00);
+    }
+
+    std::vector<std::pair<std::string, std::string>> MemoryProvider::getDataInformation() {
+        std::vector<std::pair<std::string, std::string>> result;
+
+        result.emplace_back("Name", this->m_name);
+        result.emplace_back("Size", hex::toByteString(this->getActualSize()));
+
+        return result;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "providers/process_memory_provider.hpp"
+
+#if defined(OS_LINUX)
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace hex::prv {
+
+    ProcessMemoryProvider::ProcessMemoryProvider(pid_t pid) : Provider(), m_pid(pid) {
+        std::ifstream comm(hex::format("/proc/%d/comm", pid));
+        std::getline(comm, this->m_processName);
+
+        // Only used if the kernel doesn't support process_vm_readv
+        this->m_memoryFile = open(hex::format("/proc/%d/mem", pid).c_str(), O_RDONLY);
+
+        this->parseSegments();
+
+        this->enableBlockCache(PageSize, CachedPageCount);
+    }
+
+    ProcessMemoryProvider::~ProcessMemoryProvider() {
+        if (this->m_memoryFile != -1)
+            close(this->m_memoryFile);
+    }
+
+    void ProcessMemoryProvider::parseSegments() {
+        this->m_segments.clear();
+
+        std::ifstream maps(hex::format("/proc/%d/maps", this->m_pid));
+
+        std::string line;
+        while (std::getline(maps, line)) {
+            u64 start = 0, end = 0;
+            char permissions[5] = { 0 };
+            int pathOffset = 0;
+
+            if (sscanf(line.c_str(), "%" SCNx64 "-%" SCNx64 " %4s %*s %*s %*s %n", &start, &end, permissions, &pathOffset) < 3)
+                continue;
+
+            if (permissions[0] != 'r' || end <= start)
+                continue;
+
+            std::string path;
+            if (pathOffset > 0 && size_t(pathOffset) < line.size())
+                path = line.substr(pathOffset);
+
+            this->m_segments.push_back({ start, end - start, permissions, path });
+        }
+
+        if (this->m_selectedSegment >= this->m_segments.size())
+            this->m_selectedSegment = 0;
+    }
+
+
+    bool ProcessMemoryProvider::isAvailable() {
+        return !this->m_segments.empty();
+    }
+
+    bool ProcessMemoryProvider::isReadable() {
+        return isAvailable();
+    }
+
+    bool ProcessMemoryProvider::isWritable() {
+        return false;
+    }
+
+
+    void ProcessMemoryProvider::read(u64 offset, void *buffer, size_t size) {
+        // Bulk reads done by analyses would only flush the cache, fetch those in one go instead
+        if (size > (PageSize * CachedPageCount) / 4) {
+            this->readRaw(offset, buffer, size);
+            return;
+        }
+
+        Provider::read(offset, buffer, size);
+    }
+
+    ssize_t ProcessMemoryProvider::readProcessMemory(u64 address, void *buffer, size_t size) {
+        iovec local  = { buffer, size };
+        iovec remote = { reinterpret_cast<void*>(address), size };
+
+        ssize_t bytesRead = process_vm_readv(this->m_pid, &local, 1, &remote, 1, 0);
+        if (bytesRead == -1 && errno == ENOSYS && this->m_memoryFile != -1)
+            bytesRead = pread(this->m_memoryFile, buffer, size, address);
+
+        return bytesRead;
+    }
+
+    void ProcessMemoryProvider::readRaw(u64 offset, void *buffer, size_t size) {
+        if (buffer == nullptr || size == 0 || offset >= this->getActualSize())
+            return;
+
+        size = std::min<u64>(size, this->getActualSize() - offset);
+
+        auto output = reinterpret_cast<u8*>(buffer);
+        u64 address = this->getBaseAddress() + offset;
+
+        // The whole range is requested at once, a transfer only stops early at pages the process can't read. Those read as zeros
+        while (size > 0) {
+            ssize_t bytesRead = this->readProcessMemory(address, output, size);
+            if (bytesRead <= 0) {
+                bytesRead = std::min<u64>(size, PageSize - (address % PageSize));
+                std::memset(output, 0x00, bytesRead);
+            }
+
+            output  += bytesRead;
+            address += bytesRead;
+            size    -= bytesRead;
+        }
+    }
+
+    void ProcessMemoryProvider::writeRaw(u64, const void*, size_t) {
+        // Process memory is only ever read, isWritable() keeps the editor from writing and applied patches get dropped
+    }
+
+    u64 ProcessMemoryProvider::getActualSize() {
+        if (this->m_segments.empty())
+            return 0;
+
+        return this->m_segments[this->m_selectedSegment].size;
+    }
+
+    u64 ProcessMemoryProvider::getBaseAddress() {
+        if (this->m_segments.empty())
+            return 0;
+
+        return this->m_segments[this->m_selectedSegment].address;
+    }
+
+    void ProcessMemoryProvider::selectSegment(size_t index) {
+        if (index >= this->m_segments.size())
+            return;
+
+        this->m_selectedSegment = index;
+        this->m_blockCache->clear();
+    }
+
+    void ProcessMemoryProvider::refresh() {
+        u64 selectedAddress = this->getBaseAddress();
+
+        this->parseSegments();
+
+        // Keep the same segment selected if it's still mapped
+        for (size_t i = 0; i < this->m_segments.size(); i++) {
+            if (this->m_segments[i].address == selectedAddress) {
+                this->m_selectedSegment = i;
+                break;
+            }
+        }
+
+        this->m_blockCache->clear();
+    }
+
+    std::vector<std::pair<std::string, std::string>> ProcessMemoryProvider::getDataInformation() {
+        std::vector<std::pair<std::string, std::string>> result;
+
+        result.emplace_back("Process", hex::format("%s (%d)", this->m_processName.c_str(), this->m_pid));
+        result.emplace_back("Segments", std::to_string(this->m_segments.size()));
+
+        if (!this->m_segments.empty()) {
+            const auto &segment = this->m_segments[this->m_selectedSegment];
+
+            result.emplace_back("Segment", hex::format("0x%016" PRIx64 " - 0x%016" PRIx64, segment.address, segment.address + segment.size));
+            result.emplace_back("Permissions", segment.permissions);
+            result.emplace_back("Mapped file", segment.path.empty() ? "-" : segment.path);
+            result.emplace_back("Size", hex::toByteString(segment.size));
+        }
+
+        return result;
+    }
+
+}
+
+#endif
\ No newline at end of file
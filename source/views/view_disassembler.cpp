@@ -10,7 +10,14 @@ using namespace std::literals::string_literals;
 namespace hex {
 
     ViewDisassembler::ViewDisassembler() : View("Disassembler") {
-        View::subscribeEvent(Events::DataChanged, [this](const void*){
+        View::subscribeEvent(Events::DataChanged, [this](const void *userData){
+            // Changes outside of the disassembled region don't affect the disassembly
+            if (userData != nullptr) {
+                Region region = *static_cast<const Region*>(userData);
+                if (region.address > this->m_codeRegion[1] || region.address + region.size <= this->m_codeRegion[0])
+                    return;
+            }
+
             this->m_shouldInvalidate = true;
         });
 
@@ -52,10 +59,10 @@ namespace hex {
             if (cs_open(Disassembler::toCapstoneArchictecture(this->m_architecture), mode, &capstoneHandle) == CS_ERR_OK) {
 
                 auto provider = *SharedData::get().currentProvider;
-                std::vector<u8> buffer(2048, 0x00);
                 for (u64 address = 0; address < (this->m_codeRegion[1] - this->m_codeRegion[0] + 1); address += 2048) {
                     size_t bufferSize = std::min(u64(2048), (this->m_codeRegion[1] - this->m_codeRegion[0] + 1) - address);
-                    provider->read(this->m_codeRegion[0] + address, buffer.data(), bufferSize);
+                    auto buffer = provider->getView(this->m_codeRegion[0] + address, bufferSize);
+                    bufferSize = buffer.size();
 
                     size_t instructionCount = cs_disasm(capstoneHandle, buffer.data(), bufferSize, this->m_baseAddress + address, 0, &instructions);
 
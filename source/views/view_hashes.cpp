@@ -11,7 +11,14 @@
 namespace hex {
 
     ViewHashes::ViewHashes() : View("Hashes") {
-        View::subscribeEvent(Events::DataChanged, [this](const void*){
+        View::subscribeEvent(Events::DataChanged, [this](const void *userData){
+            // Changes outside of the hashed region don't affect the hash
+            if (userData != nullptr) {
+                Region region = *static_cast<const Region*>(userData);
+                if (region.address > this->m_hashRegion[1] || region.address + region.size <= this->m_hashRegion[0])
+                    return;
+            }
+
             this->m_shouldInvalidate = true;
         });
 
@@ -2,6 +2,9 @@
 
 #include "providers/provider.hpp"
 #include "providers/file_provider.hpp"
+#include "providers/compressed_file_provider.hpp"
+#include "providers/process_memory_provider.hpp"
+#include "providers/memory_provider.hpp"
 
 #include <GLFW/glfw3.h>
 
@@ -9,9 +12,15 @@
 #include "helpers/patches.hpp"
 #include "helpers/project_file_handler.hpp"
 #include "helpers/loader_script_handler.hpp"
+#include "helpers/search.hpp"
 
 #undef __STRICT_ANSI__
+#include <cctype>
+#include <cinttypes>
 #include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
 
 namespace hex {
 
@@ -29,26 +38,35 @@ namespace hex {
             return byte;
         };
 
+        this->m_memoryEditor.BulkReadFn = [](const ImU8*, size_t off, ImU8 *buf, size_t size) -> void {
+            auto provider = *SharedData::get().currentProvider;
+            if (!provider->isAvailable() || !provider->isReadable()) {
+                std::memset(buf, 0x00, size);
+                return;
+            }
+
+            provider->read(off, buf, size);
+        };
+
         this->m_memoryEditor.WriteFn = [](ImU8 *data, size_t off, ImU8 d) -> void {
             auto provider = *SharedData::get().currentProvider;
             if (!provider->isAvailable() || !provider->isWritable())
                 return;
 
             provider->write(off, &d, sizeof(ImU8));
-            View::postEvent(Events::DataChanged);
+
+            Region changedRegion = { off, sizeof(ImU8) };
+            View::postEvent(Events::DataChanged, &changedRegion);
             ProjectFile::markDirty();
         };
 
         this->m_memoryEditor.HighlightFn = [](const ImU8 *data, size_t off, bool next) -> bool {
             ViewHexEditor *_this = (ViewHexEditor *) data;
 
-            std::optional<u32> currColor, prevColor;
-            if (_this->m_highlightedBytes.contains(off))
-                currColor = _this->m_highlightedBytes[off];
-            if (_this->m_highlightedBytes.contains(off - 1))
-                prevColor = _this->m_highlightedBytes[off - 1];
+            auto &cursor = _this->m_highlightCursor;
+            auto currColor = _this->m_highlights.find(off, cursor);
 
-            if (next && prevColor != currColor) {
+            if (next && _this->m_highlights.find(off - 1, cursor) != currColor) {
                 return false;
             }
 
@@ -72,11 +90,9 @@ namespace hex {
             const Region &region = *reinterpret_cast<const Region*>(userData);
 
             auto provider = *SharedData::get().currentProvider;
-            auto page = provider->getPageOfAddress(region.address);
-            if (!page.has_value())
+            if (provider == nullptr || region.address >= provider->getSize())
                 return;
 
-            provider->setCurrentPage(page.value());
             this->m_memoryEditor.GotoAddr = region.address;
             this->m_memoryEditor.DataPreviewAddr = region.address;
             this->m_memoryEditor.DataPreviewAddrEnd = region.address + region.size - 1;
@@ -97,11 +113,19 @@ namespace hex {
             }
         });
 
+        View::subscribeEvent(Events::ProviderClosing, [this](const void*) {
+            this->m_searchJob.reset();
+            this->m_waitingForIndex = false;
+        });
+
         View::subscribeEvent(Events::PatternChanged, [this](const void *userData) {
-           this->m_highlightedBytes.clear();
+           this->m_highlights.clear();
 
            for (const auto &pattern : this->m_patternData)
-               this->m_highlightedBytes.merge(pattern->getHighlightedAddresses());
+               pattern->addHighlightedRegions(this->m_highlights);
+
+           this->m_highlights.build();
+           this->m_highlightCursor = 0;
         });
     }
 
@@ -112,40 +136,28 @@ namespace hex {
     void ViewHexEditor::drawContent() {
         auto provider = *SharedData::get().currentProvider;
 
+        if (provider != nullptr) {
+            for (auto &changedRegion : provider->checkForChanges())
+                View::postEvent(Events::DataChanged, &changedRegion);
+
+            this->processSearch();
+        }
+
         size_t dataSize = (provider == nullptr || !provider->isReadable()) ? 0x00 : provider->getSize();
 
         this->m_memoryEditor.DrawWindow("Hex Editor", &this->getWindowOpenState(), this, dataSize, dataSize == 0 ? 0x00 : provider->getBaseAddress());
 
         if (dataSize != 0x00) {
-            ImGui::Begin("Hex Editor");
-            ImGui::SameLine();
-            ImGui::Spacing();
-            ImGui::SameLine();
-            ImGui::Text("Page %d / %d", provider->getCurrentPage() + 1, provider->getPageCount());
-            ImGui::SameLine();
-
-            if (ImGui::ArrowButton("prevPage", ImGuiDir_Left)) {
-                provider->setCurrentPage(provider->getCurrentPage() - 1);
-
-                Region dataPreview = { std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd), 1 };
-                View::postEvent(Events::RegionSelected, &dataPreview);
-            }
-
-            ImGui::SameLine();
-
-            if (ImGui::ArrowButton("nextPage", ImGuiDir_Right)) {
-                provider->setCurrentPage(provider->getCurrentPage() + 1);
-
-                Region dataPreview = { std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd), 1 };
-                View::postEvent(Events::RegionSelected, &dataPreview);
-            }
-
-            ImGui::End();
-
             this->drawSearchPopup();
             this->drawGotoPopup();
         }
 
+        this->drawIndexingPopup();
+
+        #if defined(OS_LINUX)
+        this->drawProcessPopup();
+        #endif
+
 
         if (ImGui::BeginPopupModal("Save Changes", nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
             constexpr auto Message = "You have unsaved changes made to your Project.\nAre you sure you want to exit?";
@@ -183,11 +195,16 @@ namespace hex {
             ImGui::NewLine();
 
             confirmButtons("Load", "Cancel",
-                [this, &provider] {
-                    if (!this->m_loaderScriptScriptPath.empty() && !this->m_loaderScriptFilePath.empty()) {
-                        this->openFile(this->m_loaderScriptFilePath);
+                [this] {
+                    if (!this->m_loaderScriptScriptPath.empty()) {
+                        // Without an input file the script generates its data into an empty buffer
+                        if (this->m_loaderScriptFilePath.empty())
+                            this->openMemory({ }, std::filesystem::path(this->m_loaderScriptScriptPath).filename().string());
+                        else
+                            this->openFile(this->m_loaderScriptFilePath);
+
                         LoaderScript::setFilePath(this->m_loaderScriptFilePath);
-                        LoaderScript::setDataProvider(provider);
+                        LoaderScript::setDataProvider(*SharedData::get().currentProvider);
                         LoaderScript::processFile(this->m_loaderScriptScriptPath);
                         ImGui::CloseCurrentPopup();
                     }
@@ -206,17 +223,21 @@ namespace hex {
             this->openFile(this->m_fileBrowser.selected_path);
         }
 
+        if (this->m_fileBrowser.showFileDialog("Open Compressed File", imgui_addons::ImGuiFileBrowser::DialogMode::OPEN)) {
+            this->openCompressedFile(this->m_fileBrowser.selected_path);
+        }
+
         if (this->m_fileBrowser.showFileDialog("Open Base64 File", imgui_addons::ImGuiFileBrowser::DialogMode::OPEN)) {
             std::vector<u8> base64;
             this->loadFromFile(this->m_fileBrowser.selected_path, base64);
 
             if (!base64.empty()) {
-                this->m_dataToSave = decode64(base64);
+                auto data = decode64(base64);
 
-                if (this->m_dataToSave.empty())
+                if (data.empty())
                     View::showErrorPopup("File is not in a valid Base64 format!");
                 else
-                    ImGui::OpenPopup("Save Data");
+                    this->openMemory(std::move(data), std::filesystem::path(this->m_fileBrowser.selected_path).filename().string());
             } else View::showErrorPopup("Failed to open file!");
 
         }
@@ -238,41 +259,35 @@ namespace hex {
 
         if (this->m_fileBrowser.showFileDialog("Apply IPS Patch", imgui_addons::ImGuiFileBrowser::DialogMode::OPEN)) {
             auto patchData = hex::readFile(this->m_fileBrowser.selected_path);
-            auto patch = hex::loadIPSPatch(patchData);
+            auto patch = prv::PatchMap(hex::loadIPSPatch(patchData));
 
-            for (auto &[address, value] : patch) {
-                provider->write(address, &value, 1);
+            provider->beginTransaction();
+            for (auto &[address, bytes] : patch) {
+                provider->write(address, bytes.data(), bytes.size());
             }
+
+            Region changedRegion = provider->commitTransaction();
+            View::postEvent(Events::DataChanged, &changedRegion);
+            ProjectFile::markDirty();
         }
 
         if (this->m_fileBrowser.showFileDialog("Apply IPS32 Patch", imgui_addons::ImGuiFileBrowser::DialogMode::OPEN)) {
             auto patchData = hex::readFile(this->m_fileBrowser.selected_path);
-            auto patch = hex::loadIPS32Patch(patchData);
+            auto patch = prv::PatchMap(hex::loadIPS32Patch(patchData));
 
-            for (auto &[address, value] : patch) {
-                provider->write(address, &value, 1);
+            provider->beginTransaction();
+            for (auto &[address, bytes] : patch) {
+                provider->write(address, bytes.data(), bytes.size());
             }
+
+            Region changedRegion = provider->commitTransaction();
+            View::postEvent(Events::DataChanged, &changedRegion);
+            ProjectFile::markDirty();
         }
 
         if (this->m_fileBrowser.showFileDialog("Save As", imgui_addons::ImGuiFileBrowser::DialogMode::SAVE)) {
-            FILE *file = fopen(this->m_fileBrowser.selected_path.c_str(), "wb");
-
-            if (file != nullptr) {
-                std::vector<u8> buffer(0xFF'FFFF, 0x00);
-                size_t bufferSize = buffer.size();
-
-                fseek(file, 0, SEEK_SET);
-
-                for (u64 offset = 0; offset < provider->getActualSize(); offset += bufferSize) {
-                    if (bufferSize > provider->getActualSize() - offset)
-                        bufferSize = provider->getActualSize() - offset;
-
-                    provider->read(offset, buffer.data(), bufferSize);
-                    fwrite(buffer.data(), 1, bufferSize, file);
-                }
-
-                fclose(file);
-            }
+            if (!provider->saveAs(this->m_fileBrowser.selected_path))
+                View::showErrorPopup("Failed to save file!");
         }
     }
 
@@ -285,9 +300,19 @@ namespace hex {
                 View::doLater([]{ ImGui::OpenPopup("Open File"); });
             }
 
+            if (ImGui::MenuItem("Open Compressed File...")) {
+                this->getWindowOpenState() = true;
+                View::doLater([]{ ImGui::OpenPopup("Open Compressed File"); });
+            }
+
+            #if defined(OS_LINUX)
+            if (ImGui::MenuItem("Open Process...")) {
+                View::doLater([]{ ImGui::OpenPopup("Open Process"); });
+            }
+            #endif
+
             if (ImGui::MenuItem("Save", "CTRL + S", false, provider != nullptr && provider->isWritable())) {
-                for (const auto &[address, value] : provider->getPatches())
-                    provider->writeRaw(address, &value, sizeof(u8));
+                provider->applyPatches();
             }
 
             if (ImGui::MenuItem("Save As...", "CTRL + SHIFT + S", false, provider != nullptr && provider->isWritable())) {
@@ -318,6 +343,13 @@ namespace hex {
                     View::doLater([]{ ImGui::OpenPopup("Open Base64 File"); });
                 }
 
+                if (ImGui::MenuItem("Clipboard")) {
+                    if (auto clipboard = ImGui::GetClipboardText(); clipboard != nullptr && clipboard[0] != '\0')
+                        this->openMemory(std::vector<u8>(clipboard, clipboard + std::strlen(clipboard)), "Clipboard");
+                    else
+                        View::showErrorPopup("Clipboard is empty!");
+                }
+
                 ImGui::Separator();
 
                 if (ImGui::MenuItem("IPS Patch")) {
@@ -342,7 +374,7 @@ namespace hex {
 
             if (ImGui::BeginMenu("Export...", provider != nullptr && provider->isWritable())) {
                 if (ImGui::MenuItem("IPS Patch")) {
-                    Patches patches = provider->getPatches();
+                    Patches patches = provider->getPatches().flatten();
                     if (!patches.contains(0x00454F45) && patches.contains(0x00454F46)) {
                         u8 value = 0;
                         provider->read(0x00454F45, &value, sizeof(u8));
@@ -353,7 +385,7 @@ namespace hex {
                     View::doLater([]{ ImGui::OpenPopup("Export File"); });
                 }
                 if (ImGui::MenuItem("IPS32 Patch")) {
-                    Patches patches = provider->getPatches();
+                    Patches patches = provider->getPatches().flatten();
                     if (!patches.contains(0x00454F45) && patches.contains(0x45454F46)) {
                         u8 value = 0;
                         provider->read(0x45454F45, &value, sizeof(u8));
@@ -385,6 +417,20 @@ namespace hex {
         }
 
         if (ImGui::BeginMenu("Edit")) {
+            if (ImGui::MenuItem("Undo", "CTRL + Z", false, provider != nullptr && provider->canUndo())) {
+                auto region = provider->undo();
+                View::postEvent(Events::DataChanged, &region);
+                ProjectFile::markDirty();
+            }
+
+            if (ImGui::MenuItem("Redo", "CTRL + Y", false, provider != nullptr && provider->canRedo())) {
+                auto region = provider->redo();
+                View::postEvent(Events::DataChanged, &region);
+                ProjectFile::markDirty();
+            }
+
+            ImGui::Separator();
+
             if (ImGui::BeginMenu("Copy as...", this->m_memoryEditor.DataPreviewAddr != -1 && this->m_memoryEditor.DataPreviewAddrEnd != -1)) {
                 if (ImGui::MenuItem("Bytes", "CTRL + ALT + C"))
                     this->copyBytes();
@@ -433,8 +479,7 @@ namespace hex {
     bool ViewHexEditor::handleShortcut(int key, int mods) {
         if (mods == GLFW_MOD_CONTROL && key == GLFW_KEY_S) {
             auto provider = *SharedData::get().currentProvider;
-            for (const auto &[address, value] : provider->getPatches())
-                provider->writeRaw(address, &value, sizeof(u8));
+            provider->applyPatches();
             return true;
         } else if (mods == (GLFW_MOD_CONTROL | GLFW_MOD_SHIFT) && key == GLFW_KEY_S) {
             ImGui::OpenPopup("Save As");
@@ -454,6 +499,22 @@ namespace hex {
         } else if (mods == (GLFW_MOD_CONTROL | GLFW_MOD_SHIFT) && key == GLFW_KEY_C) {
             this->copyString();
             return true;
+        } else if (mods == GLFW_MOD_CONTROL && key == GLFW_KEY_Z) {
+            auto provider = *SharedData::get().currentProvider;
+            if (provider != nullptr && provider->canUndo()) {
+                auto region = provider->undo();
+                View::postEvent(Events::DataChanged, &region);
+                ProjectFile::markDirty();
+            }
+            return true;
+        } else if (mods == GLFW_MOD_CONTROL && key == GLFW_KEY_Y) {
+            auto provider = *SharedData::get().currentProvider;
+            if (provider != nullptr && provider->canRedo()) {
+                auto region = provider->redo();
+                View::postEvent(Events::DataChanged, &region);
+                ProjectFile::markDirty();
+            }
+            return true;
         }
 
         return false;
@@ -463,6 +524,9 @@ namespace hex {
     void ViewHexEditor::openFile(std::string path) {
         auto& provider = *SharedData::get().currentProvider;
 
+        // Background work on the old provider has to stop before it's gone
+        View::postEvent(Events::ProviderClosing);
+
         if (provider != nullptr)
             delete provider;
 
@@ -479,6 +543,171 @@ namespace hex {
         ProjectFile::markDirty();
     }
 
+    void ViewHexEditor::openCompressedFile(std::string path) {
+        auto& provider = *SharedData::get().currentProvider;
+
+        // Background work on the old provider has to stop before it's gone
+        View::postEvent(Events::ProviderClosing);
+
+        if (provider != nullptr)
+            delete provider;
+
+        auto compressedProvider = new prv::CompressedFileProvider(path);
+        provider = compressedProvider;
+        this->m_memoryEditor.ReadOnly = !provider->isWritable();
+
+        // Files without a stored index are only available once it got built
+        this->m_waitingForIndex = compressedProvider->isIndexing();
+        if (this->m_waitingForIndex)
+            View::doLater([]{ ImGui::OpenPopup("Decompressing"); });
+        else if (!provider->isAvailable())
+            View::showErrorPopup("Failed to decompress file!");
+
+        this->getWindowOpenState() = true;
+
+        View::postEvent(Events::FileLoaded);
+        View::postEvent(Events::DataChanged);
+    }
+
+    void ViewHexEditor::drawIndexingPopup() {
+        auto compressedProvider = dynamic_cast<prv::CompressedFileProvider*>(*SharedData::get().currentProvider);
+
+        if (this->m_waitingForIndex && compressedProvider != nullptr && !compressedProvider->isIndexing()) {
+            this->m_waitingForIndex = false;
+
+            if (compressedProvider->isAvailable()) {
+                View::postEvent(Events::FileLoaded);
+                View::postEvent(Events::DataChanged);
+            } else
+                View::showErrorPopup("Failed to decompress file!");
+        }
+
+        if (ImGui::BeginPopupModal("Decompressing", nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
+            if (!this->m_waitingForIndex || compressedProvider == nullptr)
+                ImGui::CloseCurrentPopup();
+            else {
+                ImGui::TextUnformatted("Building the index of the compressed file...");
+                ImGui::ProgressBar(compressedProvider->getIndexingProgress(), ImVec2(300, 0));
+
+                // Cancelling closes the file, the provider can't be used without its index
+                if (ImGui::Button("Cancel")) {
+                    View::postEvent(Events::ProviderClosing);
+
+                    delete *SharedData::get().currentProvider;
+                    *SharedData::get().currentProvider = nullptr;
+
+                    View::postEvent(Events::DataChanged);
+                    ImGui::CloseCurrentPopup();
+                }
+            }
+
+            ImGui::EndPopup();
+        }
+    }
+
+    void ViewHexEditor::openMemory(std::vector<u8> &&data, std::string name) {
+        auto& provider = *SharedData::get().currentProvider;
+
+        // Background work on the old provider has to stop before it's gone
+        View::postEvent(Events::ProviderClosing);
+
+        if (provider != nullptr)
+            delete provider;
+
+        provider = new prv::MemoryProvider(std::move(data), std::move(name));
+        this->m_memoryEditor.ReadOnly = !provider->isWritable();
+
+        this->getWindowOpenState() = true;
+
+        View::postEvent(Events::FileLoaded);
+        View::postEvent(Events::DataChanged);
+    }
+
+    #if defined(OS_LINUX)
+    void ViewHexEditor::openProcess(int pid) {
+        auto& provider = *SharedData::get().currentProvider;
+
+        // Background work on the old provider has to stop before it's gone
+        View::postEvent(Events::ProviderClosing);
+
+        if (provider != nullptr)
+            delete provider;
+
+        provider = new prv::ProcessMemoryProvider(pid);
+        this->m_memoryEditor.ReadOnly = !provider->isWritable();
+
+        if (!provider->isAvailable())
+            View::showErrorPopup("Failed to read the memory map of the process!");
+
+        this->getWindowOpenState() = true;
+
+        View::postEvent(Events::FileLoaded);
+        View::postEvent(Events::DataChanged);
+    }
+
+    void ViewHexEditor::drawProcessPopup() {
+        if (ImGui::BeginPopupModal("Open Process", nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
+            ImGui::InputInt("PID", &this->m_processId, 0, 0);
+            ImGui::SameLine();
+            if (ImGui::Button("Attach"))
+                this->openProcess(this->m_processId);
+
+            if (auto processProvider = dynamic_cast<prv::ProcessMemoryProvider*>(*SharedData::get().currentProvider); processProvider != nullptr) {
+                ImGui::SameLine();
+                if (ImGui::Button("Refresh")) {
+                    processProvider->refresh();
+                    View::postEvent(Events::DataChanged);
+                }
+
+                ImGui::NewLine();
+
+                if (ImGui::BeginTable("##segments", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY, ImVec2(700, 300))) {
+                    ImGui::TableSetupScrollFreeze(0, 1);
+                    ImGui::TableSetupColumn("Segment");
+                    ImGui::TableSetupColumn("Permissions");
+                    ImGui::TableSetupColumn("Mapped file");
+                    ImGui::TableHeadersRow();
+
+                    const auto &segments = processProvider->getSegments();
+
+                    ImGuiListClipper clipper;
+                    clipper.Begin(segments.size());
+
+                    while (clipper.Step()) {
+                        for (u64 i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                            const auto &segment = segments[i];
+
+                            ImGui::TableNextRow();
+                            ImGui::TableNextColumn();
+                            ImGui::PushID(i);
+                            if (ImGui::Selectable("##segment", i == processProvider->getSelectedSegment(), ImGuiSelectableFlags_SpanAllColumns)) {
+                                processProvider->selectSegment(i);
+                                View::postEvent(Events::DataChanged);
+                            }
+                            ImGui::PopID();
+                            ImGui::SameLine();
+                            ImGui::Text("0x%016" PRIx64 " - 0x%016" PRIx64, segment.address, segment.address + segment.size);
+                            ImGui::TableNextColumn();
+                            ImGui::TextUnformatted(segment.permissions.c_str());
+                            ImGui::TableNextColumn();
+                            ImGui::TextUnformatted(segment.path.c_str());
+                        }
+                    }
+                    clipper.End();
+
+                    ImGui::EndTable();
+                }
+            }
+
+            ImGui::NewLine();
+            if (ImGui::Button("Close"))
+                ImGui::CloseCurrentPopup();
+
+            ImGui::EndPopup();
+        }
+    }
+    #endif
+
     bool ViewHexEditor::saveToFile(std::string path, const std::vector<u8>& data) {
         FILE *file = fopen(path.c_str(), "wb");
 
@@ -756,82 +985,166 @@ R"(
         ImGui::SetClipboardText(str.c_str());
     }
 
-    static std::vector<std::pair<u64, u64>> findString(prv::Provider* &provider, std::string string) {
-        std::vector<std::pair<u64, u64>> results;
+    static std::unique_ptr<SearchJob> findString(prv::Provider* &provider, std::string string, std::string &error) {
+        if (string.empty()) {
+            error = "Empty search string";
+            return nullptr;
+        }
+
+        return searchSequence(provider, std::vector<u8>(string.begin(), string.end()));
+    }
 
-        u32 foundCharacters = 0;
+    static bool parseHexPattern(const std::string &string, std::vector<u8> &bytes, std::vector<u8> &mask, std::string &error) {
+        // Bytes may be separated by spaces, single digit bytes get a leading zero and ? matches any nibble
+        std::string digits;
+        for (size_t i = 0; i <= string.size(); i++) {
+            if (i < string.size() && !std::isspace(string[i])) {
+                if (!std::isxdigit(string[i]) && string[i] != '?') {
+                    error = hex::format("Invalid character '%c' in hex pattern", string[i]);
+                    return false;
+                }
 
-        std::vector<u8> buffer(1024, 0x00);
-        size_t dataSize = provider->getSize();
-        for (u64 offset = 0; offset < dataSize; offset += 1024) {
-            size_t usedBufferSize = std::min(u64(buffer.size()), dataSize - offset);
-            provider->read(offset, buffer.data(), usedBufferSize);
+                digits += string[i];
+                continue;
+            }
 
-            for (u64 i = 0; i < usedBufferSize; i++) {
-                if (buffer[i] == string[foundCharacters])
-                    foundCharacters++;
-                else
-                    foundCharacters = 0;
+            if ((digits.size() % 2) == 1)
+                digits = "0" + digits;
 
-                if (foundCharacters == string.size()) {
-                    results.emplace_back(offset + i - foundCharacters + 1, offset + i + 1);
-                    foundCharacters = 0;
+            for (size_t digit = 0; digit < digits.size(); digit += 2) {
+                u8 byte = 0x00, byteMask = 0x00;
+                for (char nibble : { digits[digit], digits[digit + 1] }) {
+                    byte <<= 4;
+                    byteMask <<= 4;
+
+                    if (nibble != '?') {
+                        char nibbleString[2] = { nibble, 0 };
+                        byte |= strtoul(nibbleString, nullptr, 16);
+                        byteMask |= 0x0F;
+                    }
                 }
+
+                bytes.push_back(byte);
+                mask.push_back(byteMask);
             }
+
+            digits.clear();
+        }
+
+        if (bytes.empty()) {
+            error = "Empty hex pattern";
+            return false;
         }
 
-        return results;
+        return true;
     }
 
-    static std::vector<std::pair<u64, u64>> findHex(prv::Provider* &provider, std::string string) {
-        std::vector<std::pair<u64, u64>> results;
+    static std::unique_ptr<SearchJob> findHex(prv::Provider* &provider, std::string string, std::string &error) {
+        std::vector<u8> hex, mask;
+        if (!parseHexPattern(string, hex, mask, error))
+            return nullptr;
+
+        // Patterns made of wildcards only match every single byte
+        if (std::all_of(mask.begin(), mask.end(), [](u8 byteMask) { return byteMask == 0x00; })) {
+            error = "Hex pattern only consists of wildcards";
+            return nullptr;
+        }
+
+        if (std::all_of(mask.begin(), mask.end(), [](u8 byteMask) { return byteMask == 0xFF; }))
+            return searchSequence(provider, hex);
+        else
+            return searchMaskedSequence(provider, hex, mask);
+    }
 
-        if ((string.size() % 2) == 1)
-            string = "0" + string;
+    static std::vector<std::string> splitSearchList(const std::string &list) {
+        std::vector<std::string> lines;
 
-        std::vector<u8> hex;
-        hex.reserve(string.size() / 2);
+        for (size_t start = 0; start < list.size();) {
+            size_t end = std::min(list.find('\n', start), list.size());
 
-        for (u32 i = 0; i < string.size(); i += 2) {
-            char byte[3] = { string[i], string[i + 1], 0 };
-            hex.push_back(strtoul(byte, nullptr, 16));
+            auto line = list.substr(start, end - start);
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+
+            if (!line.empty())
+                lines.push_back(line);
+
+            start = end + 1;
         }
 
-        u32 foundCharacters = 0;
+        return lines;
+    }
 
-        std::vector<u8> buffer(1024, 0x00);
-        size_t dataSize = provider->getSize();
-        for (u64 offset = 0; offset < dataSize; offset += 1024) {
-            size_t usedBufferSize = std::min(u64(buffer.size()), dataSize - offset);
-            provider->read(offset, buffer.data(), usedBufferSize);
+    static std::unique_ptr<SearchJob> findList(prv::Provider* &provider, std::string string, std::string &error) {
+        constexpr static std::string_view HexPrefix = "hex:";
 
-            for (u64 i = 0; i < usedBufferSize; i++) {
-                if (buffer[i] == hex[foundCharacters])
-                    foundCharacters++;
-                else
-                    foundCharacters = 0;
+        // Every line is one pattern, lines starting with hex: contain bytes instead of a string
+        std::vector<std::vector<u8>> sequences;
+        for (const auto &line : splitSearchList(string)) {
+            if (line.starts_with(HexPrefix)) {
+                std::vector<u8> hex, mask;
+                if (!parseHexPattern(line.substr(HexPrefix.size()), hex, mask, error))
+                    return nullptr;
 
-                if (foundCharacters == hex.size()) {
-                    results.emplace_back(offset + i - foundCharacters + 1, offset + i + 1);
-                    foundCharacters = 0;
+                if (std::any_of(mask.begin(), mask.end(), [](u8 byteMask) { return byteMask != 0xFF; })) {
+                    error = "Wildcards are not supported in search lists";
+                    return nullptr;
                 }
-            }
+
+                sequences.push_back(hex);
+            } else
+                sequences.emplace_back(line.begin(), line.end());
         }
 
-        return results;
+        if (sequences.empty()) {
+            error = "Empty search list";
+            return nullptr;
+        }
+
+        return searchMultipleSequences(provider, sequences);
+    }
+
+    static std::unique_ptr<SearchJob> findRegex(prv::Provider* &provider, std::string string, std::string &error) {
+        auto regex = ByteRegex::compile(string, error);
+
+        if (!regex.has_value())
+            return nullptr;
+
+        return searchRegex(provider, regex.value());
     }
 
 
+    void ViewHexEditor::processSearch() {
+        if (this->m_searchJob == nullptr)
+            return;
+
+        this->m_searchJob->process(SearchTimeBudget);
+
+        bool done = this->m_searchJob->isDone();
+        this->m_searchJob->takeResults(*this->m_searchResults);
+
+        if (this->m_searchJumpPending && !this->m_searchResults->empty()) {
+            auto result = this->m_searchResults->get(0);
+            this->m_memoryEditor.GotoAddrAndHighlight(result.start, result.end);
+            this->m_searchJumpPending = false;
+        }
+
+        if (done)
+            this->m_searchJob.reset();
+    }
+
     void ViewHexEditor::drawSearchPopup() {
         static auto InputCallback = [](ImGuiInputTextCallbackData* data) -> int {
-            auto _this = static_cast<ViewHexEditor*>(data->UserData);
-            auto provider = *SharedData::get().currentProvider;
-
-            *_this->m_lastSearchBuffer = _this->m_searchFunction(provider, data->Buf);
-            _this->m_lastSearchIndex = 0;
+            // Hex patterns may contain ? wildcards and spaces on top of hex digits
+            return !(data->EventChar < 0x80 && (std::isxdigit(data->EventChar) || data->EventChar == '?' || data->EventChar == ' '));
+        };
 
-            if (_this->m_lastSearchBuffer->size() > 0)
-                _this->m_memoryEditor.GotoAddrAndHighlight((*_this->m_lastSearchBuffer)[0].first, (*_this->m_lastSearchBuffer)[0].second);
+        static auto ResizeCallback = [](ImGuiInputTextCallbackData* data) -> int {
+            if (data->EventFlag == ImGuiInputTextFlags_CallbackResize) {
+                auto &string = *static_cast<std::string*>(data->UserData);
+                string.resize(data->BufTextLen);
+                data->Buf = string.data();
+            }
 
             return 0;
         };
@@ -839,18 +1152,27 @@ R"(
         static auto Find = [this](char *buffer) {
             auto provider = *SharedData::get().currentProvider;
 
-            *this->m_lastSearchBuffer = this->m_searchFunction(provider, buffer);
-            this->m_lastSearchIndex = 0;
+            // The previous search gets cancelled before the next one starts reading
+            this->m_searchJob.reset();
+            this->m_searchError.clear();
+            this->m_searchJob = this->m_searchFunction(provider, buffer, this->m_searchError);
+
+            // Invalid search strings keep the results of the last search around
+            if (this->m_searchJob == nullptr)
+                return;
 
-            if (this->m_lastSearchBuffer->size() > 0)
-                this->m_memoryEditor.GotoAddrAndHighlight((*this->m_lastSearchBuffer)[0].first, (*this->m_lastSearchBuffer)[0].second);
+            this->m_searchResults = this->m_lastSearchBuffer;
+            this->m_searchResults->clear();
+            this->m_searchResults->setLimit(MaxStoredSearchResults, this->m_sampleSearchResults ? SearchResultList::LimitMode::Sample : SearchResultList::LimitMode::Truncate);
+            this->m_lastSearchIndex = 0;
+            this->m_searchJumpPending = true;
         };
 
         static auto FindNext = [this]() {
             if (this->m_lastSearchBuffer->size() > 0) {
                 ++this->m_lastSearchIndex %= this->m_lastSearchBuffer->size();
-                this->m_memoryEditor.GotoAddrAndHighlight((*this->m_lastSearchBuffer)[this->m_lastSearchIndex].first,
-                                                          (*this->m_lastSearchBuffer)[this->m_lastSearchIndex].second);
+                auto result = this->m_lastSearchBuffer->get(this->m_lastSearchIndex);
+                this->m_memoryEditor.GotoAddrAndHighlight(result.start, result.end);
             }
         };
 
@@ -863,22 +1185,24 @@ R"(
 
                 this->m_lastSearchIndex %= this->m_lastSearchBuffer->size();
 
-                this->m_memoryEditor.GotoAddrAndHighlight((*this->m_lastSearchBuffer)[this->m_lastSearchIndex].first,
-                                                          (*this->m_lastSearchBuffer)[this->m_lastSearchIndex].second);
+                auto result = this->m_lastSearchBuffer->get(this->m_lastSearchIndex);
+                this->m_memoryEditor.GotoAddrAndHighlight(result.start, result.end);
             }
         };
 
+        // Searches go through the entire data, they only start on enter or the find button instead of on every keystroke
         if (ImGui::BeginPopup("Search")) {
             ImGui::TextUnformatted("Search");
             if (ImGui::BeginTabBar("searchTabs")) {
+                const auto previousSearchFunction = this->m_searchFunction;
                 char *currBuffer;
                 if (ImGui::BeginTabItem("String")) {
                     this->m_searchFunction = findString;
                     this->m_lastSearchBuffer = &this->m_lastStringSearch;
                     currBuffer = this->m_searchStringBuffer;
 
-                    ImGui::InputText("##nolabel", currBuffer, 0xFFFF, ImGuiInputTextFlags_CallbackCompletion,
-                                     InputCallback, this);
+                    if (ImGui::InputText("##nolabel", currBuffer, 0xFFFF, ImGuiInputTextFlags_EnterReturnsTrue))
+                        Find(currBuffer);
                     ImGui::EndTabItem();
                 }
 
@@ -887,14 +1211,66 @@ R"(
                     this->m_lastSearchBuffer = &this->m_lastHexSearch;
                     currBuffer = this->m_searchHexBuffer;
 
-                    ImGui::InputText("##nolabel", currBuffer, 0xFFFF,
-                                     ImGuiInputTextFlags_CharsHexadecimal | ImGuiInputTextFlags_CallbackCompletion,
-                                     InputCallback, this);
+                    if (ImGui::InputText("##nolabel", currBuffer, 0xFFFF, ImGuiInputTextFlags_CallbackCharFilter | ImGuiInputTextFlags_EnterReturnsTrue, InputCallback, this))
+                        Find(currBuffer);
                     ImGui::EndTabItem();
                 }
 
-                if (ImGui::Button("Find"))
+                bool listSearch = false;
+                if (ImGui::BeginTabItem("List")) {
+                    this->m_searchFunction = findList;
+                    this->m_lastSearchBuffer = &this->m_lastListSearch;
+                    listSearch = true;
+
+                    ImGui::TextUnformatted("One pattern per line, prefix byte patterns with hex:");
+                    ImGui::InputTextMultiline("##list", this->m_searchListBuffer.data(), this->m_searchListBuffer.capacity() + 1, ImVec2(400, 150),
+                                              ImGuiInputTextFlags_CallbackResize, ResizeCallback, &this->m_searchListBuffer);
+                    currBuffer = this->m_searchListBuffer.data();
+                    ImGui::EndTabItem();
+                }
+
+                if (ImGui::BeginTabItem("Regex")) {
+                    this->m_searchFunction = findRegex;
+                    this->m_lastSearchBuffer = &this->m_lastRegexSearch;
+                    currBuffer = this->m_searchRegexBuffer;
+
+                    if (ImGui::InputText("##nolabel", currBuffer, 0xFFFF, ImGuiInputTextFlags_EnterReturnsTrue))
+                        Find(currBuffer);
+                    ImGui::EndTabItem();
+                }
+
+                // Errors only belong to the tab whose search string caused them
+                if (this->m_searchFunction != previousSearchFunction)
+                    this->m_searchError.clear();
+
+                if (!this->m_searchError.empty() && currBuffer[0] != '\0')
+                    ImGui::TextColored(ImVec4(1.0F, 0.3F, 0.3F, 1.0F), "%s", this->m_searchError.c_str());
+
+                if (ImGui::Button("Find")) {
+                    if (listSearch)
+                        this->m_searchListPatterns = splitSearchList(currBuffer);
+
                     Find(currBuffer);
+                }
+
+                if (this->m_searchJob != nullptr) {
+                    ImGui::SameLine();
+                    if (ImGui::Button("Cancel"))
+                        this->m_searchJob.reset();
+                }
+
+                ImGui::SameLine();
+                ImGui::Checkbox("Sample results", &this->m_sampleSearchResults);
+
+                // Huge result sets only keep a limited number of results, either the first ones or an even sample of all of them
+                std::string foundText = hex::format("%" PRIu64 " found", this->m_lastSearchBuffer->getTotalCount());
+                if (this->m_lastSearchBuffer->isLimited())
+                    foundText += hex::format(", %s %zu shown", this->m_sampleSearchResults ? "sample of" : "first", this->m_lastSearchBuffer->size());
+
+                if (this->m_searchJob != nullptr)
+                    ImGui::ProgressBar(this->m_searchJob->getProgress(), ImVec2(-1, 0), foundText.c_str());
+                else
+                    ImGui::TextUnformatted(foundText.c_str());
 
                 if (this->m_lastSearchBuffer->size() > 0) {
                     if ((ImGui::Button("Find Next")))
@@ -906,6 +1282,44 @@ R"(
                         FindPrevious();
                 }
 
+                if (ImGui::BeginTable("##searchResults", listSearch ? 3 : 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY, ImVec2(400, 200))) {
+                    ImGui::TableSetupScrollFreeze(0, 1);
+                    ImGui::TableSetupColumn("Offset");
+                    ImGui::TableSetupColumn("Size");
+                    if (listSearch)
+                        ImGui::TableSetupColumn("Pattern");
+                    ImGui::TableHeadersRow();
+
+                    ImGuiListClipper clipper;
+                    clipper.Begin(std::min<size_t>(this->m_lastSearchBuffer->size(), std::numeric_limits<int>::max()));
+
+                    while (clipper.Step()) {
+                        // Rows get decoded together since results are only stored relative to each other
+                        this->m_lastSearchBuffer->forEach(clipper.DisplayStart, clipper.DisplayEnd - clipper.DisplayStart, [&, this](size_t index, const SearchResult &result) {
+                            ImGui::TableNextRow();
+                            ImGui::TableNextColumn();
+                            ImGui::PushID(index);
+                            if (ImGui::Selectable(hex::format("0x%08" PRIX64, result.start).c_str(), size_t(this->m_lastSearchIndex) == index, ImGuiSelectableFlags_SpanAllColumns)) {
+                                this->m_lastSearchIndex = index;
+                                this->m_memoryEditor.GotoAddrAndHighlight(result.start, result.end);
+                            }
+                            ImGui::PopID();
+
+                            ImGui::TableNextColumn();
+                            ImGui::Text("0x%" PRIX64, result.end - result.start);
+
+                            if (listSearch) {
+                                ImGui::TableNextColumn();
+                                if (result.pattern < this->m_searchListPatterns.size())
+                                    ImGui::TextUnformatted(this->m_searchListPatterns[result.pattern].c_str());
+                            }
+                        });
+                    }
+
+                    clipper.End();
+                    ImGui::EndTable();
+                }
+
                 ImGui::EndTabBar();
             }
 
@@ -964,7 +1378,6 @@ R"(
                 }
 
                 if (ImGui::Button("Goto")) {
-                    provider->setCurrentPage(std::floor(newOffset / double(prv::Provider::PageSize)));
                     this->m_memoryEditor.GotoAddr = newOffset;
                     this->m_memoryEditor.DataPreviewAddr = newOffset;
                     this->m_memoryEditor.DataPreviewAddrEnd = newOffset;
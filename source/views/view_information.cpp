@@ -4,8 +4,9 @@
 
 #include "helpers/utils.hpp"
 
+#include <algorithm>
+#include <cinttypes>
 #include <cstring>
-#include <cmath>
 #include <filesystem>
 #include <span>
 #include <vector>
@@ -16,6 +17,7 @@ namespace hex {
 
     ViewInformation::ViewInformation() : View("Information") {
         View::subscribeEvent(Events::DataChanged, [this](const void*) {
+            this->m_analysisJob.reset();
             this->m_dataValid = false;
             this->m_highestBlockEntropy = 0;
             this->m_blockEntropy.clear();
@@ -26,109 +28,118 @@ namespace hex {
             this->m_fileDescription = "";
             this->m_analyzedRegion = { 0, 0 };
         });
+
+        View::subscribeEvent(Events::ProviderClosing, [this](const void*) {
+            this->m_analysisJob.reset();
+        });
     }
 
     ViewInformation::~ViewInformation() {
         View::unsubscribeEvent(Events::DataChanged);
+        View::unsubscribeEvent(Events::ProviderClosing);
     }
 
-    static float calculateEntropy(std::array<float, 256> &valueCounts, size_t numBytes) {
-        float entropy = 0;
+    constexpr static u64 MagicBufferSize = 0x10'0000;
 
-        for (u16 i = 0; i < 256; i++) {
-            valueCounts[i] /= numBytes;
+    void ViewInformation::analyzeMagic(prv::Provider *provider) {
+        // libmagic only looks at the beginning of the data anyway, don't hand it the entire file
+        auto buffer = provider->getView(0x00, std::min(provider->getSize(), MagicBufferSize));
 
-            if (valueCounts[i] > 0)
-                entropy -= (valueCounts[i] * std::log2(valueCounts[i]));
-        }
+        this->m_fileDescription.clear();
+        this->m_mimeType.clear();
 
-        return entropy / 8;
-    }
+        std::string magicFiles;
 
-    void ViewInformation::drawContent() {
-        if (ImGui::Begin("Data Information", &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
-            ImGui::BeginChild("##scrolling", ImVec2(0, 0), false, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoNav);
+        std::error_code error;
+        for (const auto &entry : std::filesystem::directory_iterator("magic", error)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".mgc")
+                magicFiles += entry.path().string() + MAGIC_PATH_SEPARATOR;
+        }
 
-            auto provider = *SharedData::get().currentProvider;
+        if (!error) {
+            magicFiles.pop_back();
 
-            if (provider != nullptr && provider->isReadable()) {
-                if (this->m_shouldInvalidate) {
+            {
+                magic_t cookie = magic_open(MAGIC_NONE);
+                if (magic_load(cookie, magicFiles.c_str()) != -1)
+                    this->m_fileDescription = magic_buffer(cookie, buffer.data(), buffer.size());
+                else
+                    this->m_fileDescription = "";
 
-                    this->m_analyzedRegion = { provider->getBaseAddress(), provider->getBaseAddress() + provider->getSize() };
+                magic_close(cookie);
+            }
 
-                    {
-                        this->m_blockSize = std::ceil(provider->getSize() / 2048.0F);
-                        std::vector<u8> buffer(this->m_blockSize, 0x00);
-                        std::memset(this->m_valueCounts.data(), 0x00, this->m_valueCounts.size() * sizeof(u32));
-                        this->m_blockEntropy.clear();
-
-                        for (u64 i = 0; i < provider->getSize(); i += this->m_blockSize) {
-                            std::array<float, 256> blockValueCounts = { 0 };
-                            provider->read(i, buffer.data(), std::min(u64(this->m_blockSize), provider->getSize() - i));
-
-                            for (size_t j = 0; j < this->m_blockSize; j++) {
-                                blockValueCounts[buffer[j]]++;
-                                this->m_valueCounts[buffer[j]]++;
-                            }
-                            this->m_blockEntropy.push_back(calculateEntropy(blockValueCounts, this->m_blockSize));
-                        }
-
-                        this->m_averageEntropy = calculateEntropy(this->m_valueCounts, provider->getSize());
-                        this->m_highestBlockEntropy = *std::max_element(this->m_blockEntropy.begin(), this->m_blockEntropy.end());
-                    }
 
-                    {
-                        std::vector<u8> buffer(provider->getSize(), 0x00);
-                        provider->read(0x00, buffer.data(), buffer.size());
+            {
+                magic_t cookie = magic_open(MAGIC_MIME);
+                if (magic_load(cookie, magicFiles.c_str()) != -1)
+                    this->m_mimeType = magic_buffer(cookie, buffer.data(), buffer.size());
+                else
+                    this->m_mimeType = "";
+
+                magic_close(cookie);
+            }
 
-                        this->m_fileDescription.clear();
-                        this->m_mimeType.clear();
+        }
+    }
 
-                        std::string magicFiles;
+    void ViewInformation::processAnalysis() {
+        if (this->m_analysisJob == nullptr)
+            return;
 
-                        std::error_code error;
-                        for (const auto &entry : std::filesystem::directory_iterator("magic", error)) {
-                            if (entry.is_regular_file() && entry.path().extension() == ".mgc")
-                                magicFiles += entry.path().string() + MAGIC_PATH_SEPARATOR;
-                        }
+        this->m_analysisJob->process(AnalysisTimeBudget);
 
-                        if (!error) {
-                            magicFiles.pop_back();
+        if (!this->m_analysisJob->takeResults())
+            return;
 
-                            {
-                                magic_t cookie = magic_open(MAGIC_NONE);
-                                if (magic_load(cookie, magicFiles.c_str()) != -1)
-                                    this->m_fileDescription = magic_buffer(cookie, buffer.data(), buffer.size());
-                                else
-                                    this->m_fileDescription = "";
+        // The histogram shows how often each value occurs relative to the size of the data
+        const auto &valueCounts = this->m_analysisJob->getValueCounts();
+        const u64 dataSize = this->m_analyzedRegion.second - this->m_analyzedRegion.first;
+        for (u16 i = 0; i < 256; i++)
+            this->m_valueCounts[i] = dataSize == 0 ? 0 : float(valueCounts[i]) / dataSize;
 
-                                magic_close(cookie);
-                            }
+        this->m_blockSize = this->m_analysisJob->getBlockSize();
+        this->m_blockEntropy = this->m_analysisJob->getBlockEntropy();
+        this->m_averageEntropy = this->m_analysisJob->getAverageEntropy();
+        this->m_highestBlockEntropy = this->m_blockEntropy.empty() ? 0 : *std::max_element(this->m_blockEntropy.begin(), this->m_blockEntropy.end());
 
+        this->m_analysisJob.reset();
+        this->m_dataValid = true;
+    }
 
-                            {
-                                magic_t cookie = magic_open(MAGIC_MIME);
-                                if (magic_load(cookie, magicFiles.c_str()) != -1)
-                                    this->m_mimeType = magic_buffer(cookie, buffer.data(), buffer.size());
-                                else
-                                    this->m_mimeType = "";
+    void ViewInformation::drawContent() {
+        if (ImGui::Begin("Data Information", &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
+            ImGui::BeginChild("##scrolling", ImVec2(0, 0), false, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoNav);
 
-                                magic_close(cookie);
-                            }
+            auto provider = *SharedData::get().currentProvider;
 
-                        }
+            if (provider != nullptr && provider->isReadable()) {
+                if (this->m_shouldInvalidate) {
+                    this->m_shouldInvalidate = false;
+                    this->m_dataValid = false;
 
+                    this->m_analyzedRegion = { provider->getBaseAddress(), provider->getBaseAddress() + provider->getSize() };
+                    this->analyzeMagic(provider);
 
-                        this->m_shouldInvalidate = false;
-                        this->m_dataValid = true;
-                    }
+                    this->m_analysisJob.reset();
+                    this->m_analysisJob = std::make_unique<ByteStatisticsJob>(provider);
                 }
 
+                this->processAnalysis();
+
                 ImGui::NewLine();
 
-                if (ImGui::Button("Analyze current page"))
+                if (ImGui::Button("Analyze"))
                     this->m_shouldInvalidate = true;
 
+                if (this->m_analysisJob != nullptr) {
+                    ImGui::SameLine();
+                    if (ImGui::Button("Cancel"))
+                        this->m_analysisJob.reset();
+                    else
+                        ImGui::ProgressBar(this->m_analysisJob->getProgress(), ImVec2(-1, 0));
+                }
+
                 ImGui::NewLine();
                 ImGui::Separator();
                 ImGui::NewLine();
@@ -139,7 +150,7 @@ namespace hex {
                         ImGui::LabelText(name.c_str(), "%s", value.c_str());
                     }
 
-                    ImGui::LabelText("Analyzed region", "0x%llx - 0x%llx", this->m_analyzedRegion.first, this->m_analyzedRegion.second);
+                    ImGui::LabelText("Analyzed region", "0x%" PRIx64 " - 0x%" PRIx64, this->m_analyzedRegion.first, this->m_analyzedRegion.second);
 
                     ImGui::NewLine();
                     ImGui::Separator();
@@ -172,7 +183,7 @@ namespace hex {
 
                     ImGui::NewLine();
 
-                    ImGui::LabelText("Block size", "2048 blocks of %lu bytes", this->m_blockSize);
+                    ImGui::LabelText("Block size", "%zu blocks of %" PRIu64 " bytes", this->m_blockEntropy.size(), this->m_blockSize);
                     ImGui::LabelText("Average entropy", "%.8f", this->m_averageEntropy);
                     ImGui::LabelText("Highest entropy block", "%.8f", this->m_highestBlockEntropy);
 
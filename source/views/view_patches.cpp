@@ -6,22 +6,39 @@
 #include "helpers/project_file_handler.hpp"
 
 #include <string>
+#include <vector>
 
 using namespace std::literals::string_literals;
 
 namespace hex {
 
+    constexpr static size_t MaxDisplayedBytes = 8;
+
+    static std::string formatPatchBytes(const u8 *bytes, size_t displayedSize, size_t totalSize) {
+        std::string result;
+
+        for (size_t i = 0; i < displayedSize; i++)
+            result += hex::format("%02X ", bytes[i]);
+
+        if (totalSize > displayedSize)
+            result += "...";
+        else if (!result.empty())
+            result.pop_back();
+
+        return result;
+    }
+
     ViewPatches::ViewPatches() : View("Patches") {
         View::subscribeEvent(Events::ProjectFileStore, [this](const void*) {
             auto provider = *SharedData::get().currentProvider;
             if (provider != nullptr)
-                ProjectFile::setPatches(provider->getPatches());
+                ProjectFile::setPatches(provider->getPatches().flatten());
         });
 
         View::subscribeEvent(Events::ProjectFileLoad, [this](const void*) {
             auto provider = *SharedData::get().currentProvider;
             if (provider != nullptr)
-                provider->getPatches() = ProjectFile::getPatches();
+                provider->getPatches() = prv::PatchMap(ProjectFile::getPatches());
         });
     }
 
@@ -52,7 +69,7 @@ namespace hex {
                         ImGui::TableNextRow();
                         ImGui::TableNextColumn();
                         if (ImGui::Selectable(("##patchLine" + std::to_string(index)).c_str(), false, ImGuiSelectableFlags_SpanAllColumns)) {
-                            Region selectRegion = { address, 1 };
+                            Region selectRegion = { address, patch.size() };
                             View::postEvent(Events::SelectionChangeRequest, &selectRegion);
                         }
                         if (ImGui::IsMouseReleased(1) && ImGui::IsItemHovered()) {
@@ -60,22 +77,31 @@ namespace hex {
                             this->m_selectedPatch = address;
                         }
                         ImGui::SameLine();
-                        ImGui::Text("0x%08lX", address);
+                        if (patch.size() == 1)
+                            ImGui::Text("0x%08lX", address);
+                        else
+                            ImGui::Text("0x%08lX : 0x%08lX", address, address + patch.size() - 1);
 
                         ImGui::TableNextColumn();
-                        u8 previousValue = 0x00;
-                        provider->readRaw(address, &previousValue, sizeof(u8));
-                        ImGui::Text("0x%02X", previousValue);
+                        std::vector<u8> previousValue(std::min(patch.size(), MaxDisplayedBytes), 0x00);
+                        provider->readRaw(address, previousValue.data(), previousValue.size());
+                        ImGui::TextUnformatted(formatPatchBytes(previousValue.data(), previousValue.size(), patch.size()).c_str());
 
                         ImGui::TableNextColumn();
-                        ImGui::Text("0x%02X", patch);
+                        ImGui::TextUnformatted(formatPatchBytes(patch.data(), previousValue.size(), patch.size()).c_str());
                         index += 1;
                     }
 
                     if (ImGui::BeginPopup("PatchContextMenu")) {
                         if (ImGui::MenuItem("Remove")) {
-                            patches.erase(this->m_selectedPatch);
-                            ProjectFile::markDirty();
+                            auto extent = patches.getExtents().find(this->m_selectedPatch);
+                            if (extent != patches.end()) {
+                                Region region = { extent->first, extent->second.size() };
+                                provider->removePatches(region.address, region.size);
+
+                                View::postEvent(Events::DataChanged, &region);
+                                ProjectFile::markDirty();
+                            }
                         }
                         ImGui::EndPopup();
                     }
@@ -3,7 +3,9 @@
 #include "providers/provider.hpp"
 #include "helpers/utils.hpp"
 
+#include <algorithm>
 #include <cstring>
+#include <numeric>
 
 #include <llvm/Demangle/Demangle.h>
 
@@ -12,8 +14,27 @@ using namespace std::literals::string_literals;
 namespace hex {
 
     ViewStrings::ViewStrings() : View("Strings") {
-        View::subscribeEvent(Events::DataChanged, [this](const void*){
+        View::subscribeEvent(Events::DataChanged, [this](const void *userData){
+            // Edits only affect the strings right around them, anything else requires a new search
+            auto region = static_cast<const Region*>(userData);
+            bool updated = region != nullptr && !this->m_foundStrings.empty() && this->m_extractionJob == nullptr && this->updateStrings(*region);
+
+            if (!updated) {
+                // Large changes get extracted again in the background, just like changes during a running extraction
+                this->m_shouldInvalidate = this->m_extractionJob != nullptr || (region != nullptr && !this->m_foundStrings.empty());
+                this->m_extractionJob.reset();
+                this->m_foundStrings.clear();
+            }
+
+            this->m_textCache.clear();
+            this->invalidateFilter();
+        });
+
+        View::subscribeEvent(Events::ProviderClosing, [this](const void*){
+            this->m_extractionJob.reset();
             this->m_foundStrings.clear();
+            this->m_textCache.clear();
+            this->invalidateFilter();
         });
 
         this->m_filter = new char[0xFFFF];
@@ -22,14 +43,15 @@ namespace hex {
 
     ViewStrings::~ViewStrings() {
         View::unsubscribeEvent(Events::DataChanged);
+        View::unsubscribeEvent(Events::ProviderClosing);
         delete[] this->m_filter;
     }
 
 
     void ViewStrings::createStringContextMenu(const FoundString &foundString) {
-        if (ImGui::TableGetHoveredColumn() == 2  && ImGui::IsMouseReleased(1) && ImGui::IsItemHovered()) {
+        if (ImGui::TableGetHoveredColumn() == 3  && ImGui::IsMouseReleased(1) && ImGui::IsItemHovered()) {
             ImGui::OpenPopup("StringContextMenu");
-            this->m_selectedString = foundString.string;
+            this->m_selectedString = readString(*SharedData::get().currentProvider, foundString);
         }
         if (ImGui::BeginPopup("StringContextMenu")) {
             if (ImGui::MenuItem("Copy string")) {
@@ -46,104 +68,280 @@ namespace hex {
     }
 
 
-    void ViewStrings::drawContent() {
+    void ViewStrings::processExtraction() {
+        if (this->m_extractionJob == nullptr)
+            return;
+
+        this->m_extractionJob->process(ExtractionTimeBudget);
+
+        bool done = this->m_extractionJob->isDone();
+        this->m_extractionJob->takeResults(this->m_foundStrings);
+
+        // Strings arrive in order of their offset, the table gets sorted again once all of them are there
+        if (done) {
+            this->m_extractionJob.reset();
+            this->m_shouldSort = true;
+        }
+    }
+
+    StringExtractionSettings ViewStrings::getExtractionSettings() const {
+        auto settings = this->m_extractionSettings;
+        settings.minimumLength = std::max(this->m_minimumLength, 1);
+
+        return settings;
+    }
+
+    void ViewStrings::invalidateFilter() {
+        this->m_filterJob.reset();
+        this->m_filteredStrings.clear();
+        this->m_filteredCount = 0;
+    }
+
+    void ViewStrings::processFilter(prv::Provider *provider) {
+        if (this->m_filter[0] == '\0')
+            return;
+
+        // Strings added by the extraction since the last pass only need to be filtered themselves, they get collected into batches while it runs.
+        // A new filter starts on everything found so far right away
+        const size_t unfilteredCount = this->m_foundStrings.size() - this->m_filteredCount;
+        const bool batchReady = unfilteredCount > 0 && (this->m_filteredCount == 0 || unfilteredCount >= MinFilterBatchSize || this->m_extractionJob == nullptr);
+
+        if (this->m_filterJob == nullptr && batchReady) {
+            std::span<const FoundString> newStrings(this->m_foundStrings.begin() + this->m_filteredCount, this->m_foundStrings.end());
+            this->m_filterJob = std::make_unique<StringFilterJob>(provider, newStrings, this->m_filteredCount, this->m_filter);
+            this->m_filteredCount = this->m_foundStrings.size();
+        }
+
+        if (this->m_filterJob == nullptr)
+            return;
+
+        this->m_filterJob->process(ExtractionTimeBudget);
+
+        bool done = this->m_filterJob->isDone();
+        this->m_filterJob->takeResults(this->m_filteredStrings);
+
+        if (done)
+            this->m_filterJob.reset();
+    }
+
+    bool ViewStrings::updateStrings(const Region &region) {
         auto provider = *SharedData::get().currentProvider;
+        if (provider == nullptr || region.size > MaxUpdateSize)
+            return false;
+        if (region.size == 0)
+            return true;
 
-        if (this->m_shouldInvalidate) {
-            this->m_shouldInvalidate = false;
+        const u64 dataSize = provider->getSize();
+        const u64 regionStart = std::min(region.address, dataSize);
+        const u64 regionEnd = std::min(region.address + region.size, dataSize);
+        const auto settings = this->getExtractionSettings();
 
-            this->m_foundStrings.clear();
+        // Re-extract a window around the changed region, growing it until no string may continue beyond its edges
+        u64 start, end;
+        ExtractedStrings newStrings;
+        for (u64 margin = 0x100; ; margin *= 2) {
+            start = regionStart > margin ? regionStart - margin : 0;
+            end = std::min(regionEnd + margin, dataSize);
 
-            std::vector<u8> buffer(1024, 0x00);
-            u32 foundCharacters = 0;
+            if (end - start > MaxUpdateSize)
+                return false;
 
-            for (u64 offset = 0; offset < provider->getSize(); offset += buffer.size()) {
-                size_t readSize = std::min(u64(buffer.size()), provider->getSize() - offset);
-                provider->read(offset,  buffer.data(), readSize);
+            auto view = provider->getView(start, end - start);
 
-                for (u32 i = 0; i < readSize; i++) {
-                    if (buffer[i] >= 0x20 && buffer[i] <= 0x7E)
-                        foundCharacters++;
-                    else {
-                        if (foundCharacters >= this->m_minimumLength) {
-                            FoundString foundString;
+            newStrings = { };
+            extractStrings(view.getSpan(), view.size(), start, settings, newStrings);
 
-                            foundString.offset = offset + i - foundCharacters;
-                            foundString.size = foundCharacters;
-                            foundString.string.reserve(foundCharacters);
-                            foundString.string.resize(foundCharacters);
-                            provider->read(foundString.offset, foundString.string.data(), foundCharacters);
+            auto touchesEdge = [&](const FoundString &foundString) {
+                return (start != 0 && foundString.offset < start + MaxCharacterSize) || (end != dataSize && foundString.offset + foundString.size + MaxCharacterSize > end);
+            };
 
-                            this->m_foundStrings.push_back(foundString);
-                        }
+            bool edgeTouched = std::any_of(newStrings.strings.begin(), newStrings.strings.end(), touchesEdge) ||
+                               std::any_of(newStrings.edgeStrings.begin(), newStrings.edgeStrings.end(), [&](const PartialString &partialString) { return touchesEdge(partialString.string); });
 
-                        foundCharacters = 0;
-                    }
-                }
-            }
+            if (!edgeTouched)
+                break;
         }
 
+        // Edge strings only touch the start or end of the data here, so they're complete as well
+        for (auto &partialString : newStrings.edgeStrings) {
+            if (finishString(partialString, settings))
+                newStrings.strings.push_back(partialString.string);
+        }
+
+        std::erase_if(this->m_foundStrings, [&](const FoundString &foundString) {
+            return foundString.offset < end && foundString.offset + foundString.size > start;
+        });
+
+        // The list may be sorted by any column, new strings get merged in where the current order puts them in a single pass
+        auto sortedBefore = [&, this](const FoundString &left, const FoundString &right) {
+            return this->isSortedBefore(provider, left, right);
+        };
+
+        std::stable_sort(newStrings.strings.begin(), newStrings.strings.end(), sortedBefore);
+
+        std::vector<FoundString> merged;
+        merged.reserve(this->m_foundStrings.size() + newStrings.strings.size());
+
+        auto next = this->m_foundStrings.begin();
+        for (const auto &foundString : newStrings.strings) {
+            auto position = std::upper_bound(next, this->m_foundStrings.end(), foundString, sortedBefore);
+
+            merged.insert(merged.end(), next, position);
+            merged.push_back(foundString);
+            next = position;
+        }
+        merged.insert(merged.end(), next, this->m_foundStrings.end());
+
+        this->m_foundStrings = std::move(merged);
+
+        return true;
+    }
+
+    bool ViewStrings::isSortedBefore(prv::Provider *provider, const FoundString &left, const FoundString &right) const {
+        auto before = [ascending = this->m_sortAscending](const auto &left, const auto &right) {
+            return ascending ? left > right : left < right;
+        };
+
+        switch (this->m_sortColumn) {
+            case SortColumn::Offset:    return before(left.offset, right.offset);
+            case SortColumn::Size:      return before(left.size, right.size);
+            case SortColumn::Encoding:  return before(left.encoding, right.encoding);
+            case SortColumn::String:    return before(readString(provider, left), readString(provider, right));
+        }
+
+        return false;
+    }
+
+    void ViewStrings::sortStrings(prv::Provider *provider) {
+        if (this->m_sortColumn != SortColumn::String) {
+            std::sort(this->m_foundStrings.begin(), this->m_foundStrings.end(), [&, this](const FoundString &left, const FoundString &right) {
+                return this->isSortedBefore(provider, left, right);
+            });
+
+            return;
+        }
+
+        // Texts only get decoded for as long as the sort takes
+        std::vector<std::string> texts;
+        texts.reserve(this->m_foundStrings.size());
+        for (const auto &foundString : this->m_foundStrings)
+            texts.push_back(readString(provider, foundString));
+
+        std::vector<size_t> order(this->m_foundStrings.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&, this](size_t left, size_t right) {
+            return this->m_sortAscending ? texts[left] > texts[right] : texts[left] < texts[right];
+        });
+
+        std::vector<FoundString> sorted;
+        sorted.reserve(order.size());
+        for (size_t index : order)
+            sorted.push_back(this->m_foundStrings[index]);
+
+        this->m_foundStrings = std::move(sorted);
+    }
+
+    void ViewStrings::drawContent() {
+        auto provider = *SharedData::get().currentProvider;
+
+        if (this->m_shouldInvalidate && provider != nullptr) {
+            this->m_shouldInvalidate = false;
+
+            this->m_extractionJob.reset();
+            this->m_foundStrings.clear();
+            this->invalidateFilter();
+
+            this->m_extractionJob = std::make_unique<StringExtractionJob>(provider, this->getExtractionSettings());
+        }
+
+        this->processExtraction();
+        if (provider != nullptr)
+            this->processFilter(provider);
+
 
         if (ImGui::Begin("Strings", &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
             if (provider != nullptr && provider->isReadable()) {
                 if (ImGui::InputInt("Minimum length", &this->m_minimumLength, 1, 0))
                     this->m_shouldInvalidate = true;
 
-                ImGui::InputText("Filter", this->m_filter, 0xFFFF);
+                if (ImGui::Checkbox("ASCII", &this->m_extractionSettings.ascii))
+                    this->m_shouldInvalidate = true;
+                ImGui::SameLine();
+                if (ImGui::Checkbox("UTF-8", &this->m_extractionSettings.utf8))
+                    this->m_shouldInvalidate = true;
+                ImGui::SameLine();
+                if (ImGui::Checkbox("UTF-16LE", &this->m_extractionSettings.utf16le))
+                    this->m_shouldInvalidate = true;
+                ImGui::SameLine();
+                if (ImGui::Checkbox("UTF-16BE", &this->m_extractionSettings.utf16be))
+                    this->m_shouldInvalidate = true;
+
+                if (ImGui::InputText("Filter", this->m_filter, 0xFFFF))
+                    this->invalidateFilter();
                 if (ImGui::Button("Extract"))
                     this->m_shouldInvalidate = true;
 
+                if (this->m_extractionJob != nullptr) {
+                    ImGui::SameLine();
+                    bool cancel = ImGui::Button("Cancel");
+
+                    ImGui::ProgressBar(this->m_extractionJob->getProgress(), ImVec2(-1, 0), hex::format("%zu found", this->m_foundStrings.size()).c_str());
+
+                    if (cancel) {
+                        this->m_extractionJob.reset();
+                        this->m_shouldSort = true;
+                    }
+                }
+
+                if (this->m_filterJob != nullptr)
+                    ImGui::ProgressBar(this->m_filterJob->getProgress(), ImVec2(-1, 0), hex::format("%zu matching", this->m_filteredStrings.size()).c_str());
+
                 ImGui::Separator();
                 ImGui::NewLine();
 
-                if (ImGui::BeginTable("##strings", 3,
+                if (ImGui::BeginTable("##strings", 4,
                                       ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_Sortable |
                                       ImGuiTableFlags_Reorderable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
                     ImGui::TableSetupScrollFreeze(0, 1);
                     ImGui::TableSetupColumn("Offset", 0, -1, ImGui::GetID("offset"));
                     ImGui::TableSetupColumn("Size", 0, -1, ImGui::GetID("size"));
+                    ImGui::TableSetupColumn("Encoding", 0, -1, ImGui::GetID("encoding"));
                     ImGui::TableSetupColumn("String", 0, -1, ImGui::GetID("string"));
 
                     auto sortSpecs = ImGui::TableGetSortSpecs();
 
-                    if (sortSpecs->SpecsDirty) {
-                        std::sort(this->m_foundStrings.begin(), this->m_foundStrings.end(),
-                                  [&sortSpecs](FoundString &left, FoundString &right) -> bool {
-                                      if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("offset")) {
-                                          if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                                              return left.offset > right.offset;
-                                          else
-                                              return left.offset < right.offset;
-                                      } else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("size")) {
-                                          if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                                              return left.size > right.size;
-                                          else
-                                              return left.size < right.size;
-                                      } else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("string")) {
-                                          if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                                              return left.string > right.string;
-                                          else
-                                              return left.string < right.string;
-                                      }
-
-                                      return false;
-                                  });
+                    if (sortSpecs->SpecsDirty || this->m_shouldSort) {
+                        auto columnId = sortSpecs->Specs->ColumnUserID;
+                        if (columnId == ImGui::GetID("size"))
+                            this->m_sortColumn = SortColumn::Size;
+                        else if (columnId == ImGui::GetID("encoding"))
+                            this->m_sortColumn = SortColumn::Encoding;
+                        else if (columnId == ImGui::GetID("string"))
+                            this->m_sortColumn = SortColumn::String;
+                        else
+                            this->m_sortColumn = SortColumn::Offset;
+
+                        this->m_sortAscending = sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending;
+                        this->sortStrings(provider);
 
                         sortSpecs->SpecsDirty = false;
+                        this->m_shouldSort = false;
+                        this->invalidateFilter();
                     }
 
                     ImGui::TableHeadersRow();
 
+                    // With a filter set, the rows are the strings the filter matched so far
+                    const bool filtered = this->m_filter[0] != '\0';
+
                     ImGuiListClipper clipper;
-                    clipper.Begin(this->m_foundStrings.size());
+                    clipper.Begin(filtered ? this->m_filteredStrings.size() : this->m_foundStrings.size());
 
                     while (clipper.Step()) {
-                        for (u64 i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                        for (u64 row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                            u64 i = filtered ? this->m_filteredStrings[row] : row;
                             auto &foundString = this->m_foundStrings[i];
-
-                            if (strlen(this->m_filter) != 0 &&
-                                foundString.string.find(this->m_filter) == std::string::npos)
-                                continue;
+                            auto &text = this->m_textCache.get(provider, foundString);
 
                             ImGui::TableNextRow();
                             ImGui::TableNextColumn();
@@ -157,9 +355,11 @@ namespace hex {
                             ImGui::SameLine();
                             ImGui::Text("0x%08lx : 0x%08lx", foundString.offset, foundString.offset + foundString.size);
                             ImGui::TableNextColumn();
-                            ImGui::Text("0x%04lx", foundString.size);
+                            ImGui::Text("0x%04x", foundString.size);
+                            ImGui::TableNextColumn();
+                            ImGui::TextUnformatted(getStringEncodingName(foundString.encoding));
                             ImGui::TableNextColumn();
-                            ImGui::Text("%s", foundString.string.c_str());
+                            ImGui::Text("%s", text.c_str());
                         }
                     }
                     clipper.End();
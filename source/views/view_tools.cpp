@@ -176,12 +176,23 @@ namespace hex {
                 ImGui::SetKeyboardFocusHere();
                 std::optional<long double> result;
 
+                // Group all writes done by the expression into a single undo step
+                auto provider = *SharedData::get().currentProvider;
+                if (provider != nullptr)
+                    provider->beginTransaction();
+
                 try {
                     result = this->m_mathEvaluator.evaluate(this->m_mathInput);
                 } catch (std::invalid_argument &e) {
                     this->m_lastMathError = e.what();
                 }
 
+                if (provider != nullptr) {
+                    Region changedRegion = provider->commitTransaction();
+                    if (changedRegion.size > 0)
+                        View::postEvent(Events::DataChanged, &changedRegion);
+                }
+
                 if (result.has_value()) {
                     this->m_mathHistory.push_back(result.value());
                     std::memset(this->m_mathInput, 0x00, 0xFFFF);